@@ -206,55 +206,74 @@ struct board {
     const square white_king = man_.white.king().item();
     const square black_king = man_.black.king().item();
 
-    sided_set.white.clear();
-    sided_set.black.clear();
+    std::size_t num_features{};
+    std::size_t white_idx[h_ka::max_active_half_features];
+    std::size_t black_idx[h_ka::max_active_half_features];
 
     over_types([&](const piece_type& pt) {
       for (const auto sq : man_.white.get_plane(pt)) {
-        sided_set.white.insert(h_ka::index<color::white, color::white>(white_king, pt, sq));
-        sided_set.black.insert(h_ka::index<color::black, color::white>(black_king, pt, sq));
+        white_idx[num_features] = h_ka::index<color::white, color::white>(white_king, pt, sq);
+        black_idx[num_features++] = h_ka::index<color::black, color::white>(black_king, pt, sq);
       }
     });
 
     over_types([&](const piece_type& pt) {
       for (const auto sq : man_.black.get_plane(pt)) {
-        sided_set.white.insert(h_ka::index<color::white, color::black>(white_king, pt, sq));
-        sided_set.black.insert(h_ka::index<color::black, color::black>(black_king, pt, sq));
+        white_idx[num_features] = h_ka::index<color::white, color::black>(white_king, pt, sq);
+        black_idx[num_features++] = h_ka::index<color::black, color::black>(black_king, pt, sq);
       }
     });
+
+    sided_set.white.clear_insert_many(white_idx, num_features);
+    sided_set.black.clear_insert_many(black_idx, num_features);
   }
 
-  template <color c, typename T0, typename T1>
-  void half_feature_partial_reset_(const move& mv, T0& feature_reset_cache, T1& sided_set) const {
+  template <color c, typename F0, typename F1, typename T0, typename T1>
+  void half_feature_cached_reset_(const square& our_king, F0&& them_plane, F1&& us_plane, T0& feature_reset_cache, T1& sided_set) const {
     namespace h_ka = feature::half_ka;
-    const square our_king = mv.to();
 
     auto& entry = feature_reset_cache.template us<c>().look_up(our_king);
     sided_piece_configuration& config = entry.config;
 
+    std::size_t num_inserts{};
+    std::size_t num_erases{};
+    std::size_t insert_idx[h_ka::max_active_half_features];
+    std::size_t erase_idx[h_ka::max_active_half_features];
+
     over_types([&](const piece_type& pt) {
       const square_set them_entry_plane = config.them<c>().get_plane(pt);
       const square_set us_entry_plane = config.us<c>().get_plane(pt);
 
-      const square_set them_board_plane = man_.them<c>().get_plane(pt).excluding(mv.to());
-      const square_set us_board_plane = [&] {
-        if (pt == piece_type::king) { return square_set::of(our_king); }
-        return man_.us<c>().get_plane(pt).excluding(mv.from());
-      }();
+      const square_set them_board_plane = them_plane(pt);
+      const square_set us_board_plane = us_plane(pt);
 
-      for (const auto sq : them_entry_plane & ~them_board_plane) { entry.erase(h_ka::index<c, opponent<c>>(our_king, pt, sq)); }
-      for (const auto sq : (us_entry_plane & ~us_board_plane)) { entry.erase(h_ka::index<c, c>(our_king, pt, sq)); }
+      for (const auto sq : them_entry_plane & ~them_board_plane) { erase_idx[num_erases++] = h_ka::index<c, opponent<c>>(our_king, pt, sq); }
+      for (const auto sq : us_entry_plane & ~us_board_plane) { erase_idx[num_erases++] = h_ka::index<c, c>(our_king, pt, sq); }
 
-      for (const auto sq : them_board_plane & ~them_entry_plane) { entry.insert(h_ka::index<c, opponent<c>>(our_king, pt, sq)); }
-      for (const auto sq : us_board_plane & ~us_entry_plane) { entry.insert(h_ka::index<c, c>(our_king, pt, sq)); }
+      for (const auto sq : them_board_plane & ~them_entry_plane) { insert_idx[num_inserts++] = h_ka::index<c, opponent<c>>(our_king, pt, sq); }
+      for (const auto sq : us_board_plane & ~us_entry_plane) { insert_idx[num_inserts++] = h_ka::index<c, c>(our_king, pt, sq); }
 
       config.them<c>().set_plane(pt, them_board_plane);
       config.us<c>().set_plane(pt, us_board_plane);
     });
 
+    entry.insert_erase_many(insert_idx, num_inserts, erase_idx, num_erases);
     entry.copy_state_to(sided_set.template us<c>());
   }
 
+  template <color c, typename T0, typename T1>
+  void half_feature_partial_reset_(const move& mv, T0& feature_reset_cache, T1& sided_set) const {
+    const square our_king = mv.to();
+    const auto them_plane = [&](const piece_type& pt) { return man_.them<c>().get_plane(pt).excluding(mv.to()); };
+
+    const auto us_plane = [&](const piece_type& pt) {
+      if (pt == piece_type::king) { return square_set::of(our_king); }
+      return man_.us<c>().get_plane(pt).excluding(mv.from());
+    };
+
+    half_feature_cached_reset_<c>(our_king, them_plane, us_plane, feature_reset_cache, sided_set);
+  }
+
   template <color pov, color p, typename T>
   void half_feature_move_delta_(const move& mv, T& sided_set) const {
     namespace h_ka = feature::half_ka;
@@ -300,6 +319,27 @@ struct board {
     half_feature_move_delta_<opponent<c>, c>(mv, sided_set);
   }
 
+  template <color c, typename T0, typename T1>
+  void half_feature_refresh(T0& feature_reset_cache, T1& sided_set) const {
+    const auto them_plane = [&](const piece_type& pt) { return man_.them<c>().get_plane(pt); };
+    const auto us_plane = [&](const piece_type& pt) { return man_.us<c>().get_plane(pt); };
+    half_feature_cached_reset_<c>(man_.us<c>().king().item(), them_plane, us_plane, feature_reset_cache, sided_set);
+  }
+
+  template <color c, typename T>
+  [[nodiscard]] std::size_t half_feature_refresh_cost(T& feature_reset_cache) const {
+    const auto& entry = feature_reset_cache.template us<c>().look_up(man_.us<c>().king().item());
+    const sided_piece_configuration& config = entry.config;
+
+    std::size_t result{};
+    over_types([&](const piece_type& pt) {
+      result += (config.them<c>().get_plane(pt) ^ man_.them<c>().get_plane(pt)).count();
+      result += (config.us<c>().get_plane(pt) ^ man_.us<c>().get_plane(pt)).count();
+    });
+
+    return result;
+  }
+
   template <typename T0, typename T1>
   void feature_move_delta(const move& mv, T0& feature_reset_cache, T1& sided_set) const {
     if (turn()) {
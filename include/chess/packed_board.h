@@ -0,0 +1,68 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chess/board.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace chess {
+
+// a fixed size, 32 byte little endian position record. the position is stored as the occupancy bit
+// board followed by one nibble per occupied square in ascending square order (black << 3 | piece_type).
+// state holds the side to move (bit 0 set for white) and the KQkq castling rights (bits 1 to 4).
+// squares use the engine's indexing, in which square 0 is h1 and square 63 is a8. score and result
+// are optional annotations from the perspective of the side to move (result: 1 win, 0 draw, -1 loss)
+// and are zero when unused.
+//
+// byte layout: [0, 8) occupancy, [8, 24) pieces, 24 state, 25 ep_square, 26 half_clock,
+// [27, 29) ply_count, [29, 31) score, 31 result.
+//
+// the nibbles leave room for at most 32 pieces, so positions with more pieces can't be packed.
+// records read from untrusted input are validated before they are unpacked: besides being well formed,
+// each side must have exactly one king, pawns must stay off the back ranks, castling rights must match
+// the king and rook squares, the ep square must follow a double push and the side not to move must not
+// be in check. the side to move must also agree with the parity of ply_count.
+struct packed_board {
+  static constexpr std::size_t num_bytes = 32;
+  static constexpr std::size_t max_pieces = 32;
+  static constexpr std::uint8_t no_ep_square = 64;
+
+  std::uint64_t occupancy{};
+  std::uint8_t pieces[16]{};
+  std::uint8_t state{};
+  std::uint8_t ep_square{no_ep_square};
+  std::uint8_t half_clock{};
+  std::uint16_t ply_count{};
+  std::int16_t score{};
+  std::int8_t result{};
+
+  [[nodiscard]] bool turn() const noexcept { return static_cast<bool>(state & 1); }
+
+  void write_to(std::uint8_t* data) const noexcept;
+  [[nodiscard]] static packed_board read_from(const std::uint8_t* data) noexcept;
+
+  [[nodiscard]] bool is_valid() const noexcept;
+
+  [[nodiscard]] std::optional<board> unpacked() const noexcept;
+  [[nodiscard]] static std::optional<packed_board> from(const board& bd) noexcept;
+};
+
+}  // namespace chess
@@ -0,0 +1,66 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <nnue/weights.h>
+#include <search/search_constants.h>
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+namespace engine {
+
+namespace analysis_config {
+
+constexpr search::depth_type init_depth = 1;
+constexpr std::size_t tt_mb_size = 16;
+
+}  // namespace analysis_config
+
+enum class analysis_limit_type { depth, nodes };
+
+struct analysis_limit {
+  analysis_limit_type type;
+  std::size_t value;
+};
+
+struct analysis_info {
+  bool success{false};
+  std::size_t positions{0};
+  std::size_t total_nodes{0};
+  std::size_t positions_per_second{0};
+  std::size_t nodes_per_second{0};
+};
+
+[[maybe_unused]] std::ostream& operator<<(std::ostream& os, const analysis_info& info) noexcept;
+
+// searches every position of input_path (one FEN per line) independently, each thread taking the next
+// position from a shared queue with its own search_worker and transposition table. a result line
+// "fen;score;best move;nodes;pv" is written to output_path as soon as each search completes, so lines
+// appear in completion order. scores are written as "cp <centipawns>" or "mate <moves>" (negative when
+// the side to move is mated). checkmated and stalemated positions are written as "mate 0" and "cp 0"
+// with an empty best move. each position is searched for a single line, regardless of MultiPV.
+[[nodiscard]] analysis_info get_analysis_info(
+    const nnue::quantized_weights& weights,
+    const std::string& input_path,
+    const std::string& output_path,
+    const analysis_limit& limit,
+    const std::size_t& thread_count) noexcept;
+
+}  // namespace engine
@@ -22,6 +22,7 @@
 #include <nnue/eval.h>
 #include <search/search_constants.h>
 #include <search/search_worker.h>
+#include <search/search_worker_orchestrator.h>
 #include <search/transposition_table.h>
 
 #include <array>
@@ -30,6 +31,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace engine {
 
@@ -38,6 +40,8 @@ namespace bench_config {
 constexpr search::depth_type init_depth = 1;
 constexpr search::depth_type bench_depth = 13;
 constexpr std::size_t tt_mb_size = 16;
+constexpr std::size_t thread_count = 1;
+constexpr std::size_t packed_board_bench_positions = 1 << 20;
 
 constexpr std::array<std::string_view, 50> fens = {
     "r3k2r/2pb1ppp/2pp1q2/p7/1nP1B3/1P2P3/P2N1PPP/R2QK2R w KQkq a6 0 14",
@@ -100,9 +104,82 @@ struct bench_info {
 
 [[maybe_unused]] std::ostream& operator<<(std::ostream& os, const bench_info& info) noexcept;
 
+// a bench run is configured by "depth <d> threads <n> hash <mb> positions <path> json" in any order,
+// each key being optional. positions holds one FEN (or EPD line) per line and replaces the built in
+// bench_config::fens. json selects the per position report over the summary line.
+struct bench_options {
+  search::depth_type depth{bench_config::bench_depth};
+  std::size_t thread_count{bench_config::thread_count};
+  std::size_t tt_mb_size{bench_config::tt_mb_size};
+  std::string positions_path{};
+  bool json{false};
+
+  [[nodiscard]] static bench_options parse(const std::string& args) noexcept;
+};
+
+struct bench_position_info {
+  std::string fen{};
+  std::size_t nodes{0};
+  std::size_t elapsed_ms{0};
+  std::size_t nodes_per_second{0};
+  search::depth_type depth{0};
+  std::string best_move{};
+};
+
+struct bench_report {
+  bool success{false};
+  bench_options options{};
+  std::vector<bench_position_info> positions{};
+  std::size_t elapsed_ms{0};
+  bench_info total{};
+
+  void write_json(std::ostream& os) const noexcept;
+};
+
+// strips the operations of an EPD line and appends move counters where they are missing.
+[[nodiscard]] std::string fen_from_epd(const std::string& line) noexcept;
+
+[[nodiscard]] bench_report get_bench_report(const nnue::quantized_weights& weights, const bench_options& options) noexcept;
 [[nodiscard]] bench_info get_bench_info(const nnue::quantized_weights& weights) noexcept;
 
-[[nodiscard]] std::size_t perft(const chess::board& bd, const search::depth_type& depth) noexcept;
-[[nodiscard]] bench_info get_perft_info(const chess::board& bd, const search::depth_type& depth) noexcept;
+struct scale_bench_row {
+  std::size_t thread_count{0};
+  std::size_t elapsed_ms{0};
+  std::size_t nodes{0};
+  std::size_t nodes_per_second{0};
+};
+
+struct scale_bench_info {
+  bool success{false};
+  search::depth_type depth{0};
+  std::vector<scale_bench_row> rows{};
+};
+
+[[maybe_unused]] std::ostream& operator<<(std::ostream& os, const scale_bench_info& info) noexcept;
+
+// runs the bench positions to a fixed depth at 1, 2, 4, ... threads up to options.thread_count
+// (including options.thread_count itself), each run starting from an empty transposition table.
+// speedups are relative to the single threaded run: time to depth, nodes to depth and nps.
+[[nodiscard]] scale_bench_info get_scale_bench_info(const nnue::quantized_weights& weights, const bench_options& options) noexcept;
+
+struct packed_board_bench_info {
+  std::size_t positions{0};
+  std::size_t mismatches{0};
+  std::size_t parse_fen_per_second{0};
+  std::size_t fen_per_second{0};
+  std::size_t unpack_per_second{0};
+  std::size_t pack_per_second{0};
+  std::size_t file_write_per_second{0};
+  std::size_t file_read_per_second{0};
+};
+
+[[maybe_unused]] std::ostream& operator<<(std::ostream& os, const packed_board_bench_info& info) noexcept;
+
+// compares the throughput of chess::packed_board encoding and decoding against board::fen and
+// board::parse_fen over the bench positions and their children, repeated to
+// bench_config::packed_board_bench_positions positions, and times streaming the records through a
+// temporary file with packed_board_writer and packed_board_reader. mismatches counts positions which
+// do not survive a round trip through the packed encoding or the file.
+[[nodiscard]] packed_board_bench_info get_packed_board_bench_info() noexcept;
 
 }  // namespace engine
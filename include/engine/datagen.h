@@ -0,0 +1,62 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chess/board.h>
+#include <nnue/weights.h>
+#include <search/search_constants.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace engine {
+
+namespace datagen_config {
+
+constexpr search::depth_type init_depth = 1;
+constexpr std::size_t tt_mb_size = 8;
+constexpr std::size_t random_plies = 8;
+constexpr std::size_t max_plies = 400;
+constexpr std::uint64_t seed = 0x5eed5eed5eed5eedull;
+
+}  // namespace datagen_config
+
+struct datagen_info {
+  bool success{false};
+  std::size_t games{0};
+  std::size_t positions{0};
+  std::size_t positions_per_second{0};
+};
+
+[[maybe_unused]] std::ostream& operator<<(std::ostream& os, const datagen_info& info) noexcept;
+
+// plays num_games self-play games on thread_count threads. each thread owns a search_worker and a
+// small private transposition table and searches every move to node_limit nodes. games start with
+// datagen_config::random_plies random moves and are adjudicated with syzygy::probe_wdl once the
+// tablebases cover the position. every position not in check is written to output_path as a
+// chess::packed_board annotated with the search score and the game result.
+[[nodiscard]] datagen_info get_datagen_info(
+    const nnue::quantized_weights& weights,
+    const std::string& output_path,
+    const std::size_t& num_games,
+    const std::size_t& thread_count,
+    const std::size_t& node_limit) noexcept;
+
+}  // namespace engine
@@ -0,0 +1,114 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chess/board.h>
+#include <chess/packed_board.h>
+#include <nnue/mapped_file.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace engine {
+
+namespace packed_board_file_config {
+
+constexpr std::size_t writer_buffer_size = 1 << 20;
+
+}
+
+// random access view over a file of packed_board records. the file is memory mapped where supported
+// and read into memory otherwise. records are decoded on access, so iterating the file performs no
+// allocation. a trailing partial record is ignored, and invalid records decode to std::nullopt.
+struct packed_board_reader {
+  nnue::mapped_file file_;
+  std::vector<std::uint8_t> fallback_{};
+  const std::uint8_t* data_{nullptr};
+  std::size_t size_{0};
+
+  struct iterator {
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::optional<chess::board>;
+    using pointer = const std::optional<chess::board>*;
+    using reference = std::optional<chess::board>;
+    using iterator_category = std::input_iterator_tag;
+
+    const packed_board_reader* reader_;
+    std::size_t idx_;
+
+    [[nodiscard]] std::optional<chess::board> operator*() const noexcept { return reader_->at(idx_); }
+    [[maybe_unused]] iterator& operator++() noexcept {
+      ++idx_;
+      return *this;
+    }
+
+    [[nodiscard]] bool operator==(const iterator& other) const noexcept { return idx_ == other.idx_; }
+    [[nodiscard]] bool operator!=(const iterator& other) const noexcept { return idx_ != other.idx_; }
+  };
+
+  [[nodiscard]] bool is_open() const noexcept { return data_ != nullptr; }
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  [[nodiscard]] chess::packed_board record_at(const std::size_t& idx) const noexcept {
+    return chess::packed_board::read_from(data_ + idx * chess::packed_board::num_bytes);
+  }
+
+  [[nodiscard]] std::optional<chess::board> at(const std::size_t& idx) const noexcept { return record_at(idx).unpacked(); }
+
+  [[nodiscard]] iterator begin() const noexcept { return iterator{this, 0}; }
+  [[nodiscard]] iterator end() const noexcept { return iterator{this, size_}; }
+
+  packed_board_reader(const packed_board_reader&) = delete;
+  packed_board_reader& operator=(const packed_board_reader&) = delete;
+
+  explicit packed_board_reader(const std::string& path) noexcept;
+};
+
+// append only writer buffering records in memory. the buffer is appended to the output stream once
+// full, on flush and on destruction. output_mutex guards the stream when it is shared between threads
+// and may be null otherwise.
+struct packed_board_writer {
+  std::ostream* output_;
+  std::mutex* output_mutex_;
+  std::vector<std::uint8_t> buffer_{};
+
+  void write(const chess::packed_board& record) noexcept;
+
+  // returns false, writing nothing, for positions which can't be packed
+  [[maybe_unused]] bool write(const chess::board& bd) noexcept {
+    const std::optional<chess::packed_board> record = chess::packed_board::from(bd);
+    if (record.has_value()) { write(*record); }
+    return record.has_value();
+  }
+
+  void flush() noexcept;
+
+  packed_board_writer(const packed_board_writer&) = delete;
+  packed_board_writer& operator=(const packed_board_writer&) = delete;
+
+  explicit packed_board_writer(std::ostream* output, std::mutex* output_mutex = nullptr) noexcept;
+  ~packed_board_writer() noexcept;
+};
+
+}  // namespace engine
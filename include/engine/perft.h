@@ -0,0 +1,103 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chess/board.h>
+#include <chess/move.h>
+#include <engine/bench.h>
+#include <search/search_constants.h>
+#include <util/bit_range.h>
+#include <zobrist/util.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace engine {
+
+namespace perft_config {
+
+constexpr std::size_t tt_mb_size = 64;
+
+}
+
+// lockless cache of perft counts keyed by board::hash() and depth. each entry stores its key xored
+// with its data, so that an entry torn by concurrent writes fails verification and reads as a miss.
+struct perft_table_entry {
+  using count_ = util::bit_range<std::uint64_t, 0, 56>;
+  using depth_ = util::next_bit_range<count_, std::uint8_t>;
+
+  std::atomic<zobrist::hash_type> key_xor_data_{};
+  std::atomic<std::uint64_t> data_{};
+};
+
+struct perft_table {
+  static constexpr std::size_t one_mb = (1 << 20) / sizeof(perft_table_entry);
+
+  std::vector<perft_table_entry> data;
+
+  [[nodiscard]] inline std::size_t hash_function(const zobrist::hash_type& hash) const noexcept { return hash % data.size(); }
+
+  [[nodiscard]] bool find(const zobrist::hash_type& key, const search::depth_type& depth, std::size_t& count) const noexcept;
+  void insert(const zobrist::hash_type& key, const search::depth_type& depth, const std::size_t& count) noexcept;
+
+  explicit perft_table(const std::size_t& size) noexcept : data(size * one_mb) {}
+};
+
+struct perft_divide_info {
+  bool turn{true};
+  std::vector<std::tuple<chess::move, std::size_t>> counts{};
+  bench_info total{};
+};
+
+[[maybe_unused]] std::ostream& operator<<(std::ostream& os, const perft_divide_info& info) noexcept;
+
+struct perft_suite_info {
+  bool success{false};
+  std::size_t positions{0};
+  std::size_t passed{0};
+  std::size_t failed{0};
+  bench_info total{};
+};
+
+[[maybe_unused]] std::ostream& operator<<(std::ostream& os, const perft_suite_info& info) noexcept;
+
+// counts the leaves depth + 1 plies below bd. table may be null.
+[[nodiscard]] std::size_t perft(const chess::board& bd, const search::depth_type& depth, perft_table* table = nullptr) noexcept;
+
+// counts the leaves depth plies below each root move. the root and second level moves are split into
+// independent work items, which thread_count threads take from a shared queue while sharing table.
+[[nodiscard]] perft_divide_info perft_divide(const chess::board& bd, const search::depth_type& depth, const std::size_t& thread_count, perft_table& table) noexcept;
+
+[[nodiscard]] bench_info get_perft_info(const chess::board& bd, const search::depth_type& depth, const std::size_t& thread_count) noexcept;
+[[nodiscard]] perft_divide_info get_perft_divide_info(const chess::board& bd, const search::depth_type& depth, const std::size_t& thread_count) noexcept;
+
+// runs every position of an EPD perft suite, one position per line in the form
+// "<fen> ;D1 <count> ;D2 <count> ...", checking the expected counts up to max_depth and writing a
+// line per failed count to os.
+[[nodiscard]] perft_suite_info get_perft_suite_info(
+    const std::string& input_path,
+    const search::depth_type& max_depth,
+    const std::size_t& thread_count,
+    std::ostream& os) noexcept;
+
+}  // namespace engine
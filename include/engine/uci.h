@@ -18,6 +18,8 @@
 #pragma once
 
 #include <chess/board.h>
+#include <chess/move_list.h>
+#include <engine/analysis.h>
 #include <engine/time_manager.h>
 #include <nnue/weights.h>
 #include <search/search_worker.h>
@@ -37,14 +39,22 @@ struct uci {
 
   static constexpr std::size_t default_thread_count = 1;
   static constexpr std::size_t default_hash_size = 16;
+  static constexpr std::size_t default_multi_pv = 1;
   static constexpr bool default_ponder = false;
+  static constexpr bool default_sparse_fc0 = false;
+  static constexpr bool default_large_pages = false;
 
   chess::board_history history{};
   chess::board position = chess::board::start_pos();
+  chess::move_list search_moves{};
 
   nnue::quantized_weights weights_{};
   search::worker_orchestrator orchestrator_;
 
+  // the Hash option's value in MB, which loadhash updates when it resizes the table
+  std::size_t hash_size_{default_hash_size};
+  bool large_pages_{default_large_pages};
+  std::string shared_hash_name_{};
   std::atomic_bool ponder_{false};
   std::atomic_bool should_quit_{false};
 
@@ -63,10 +73,13 @@ struct uci {
   void set_position(const chess::board& bd, const std::string& uci_moves = "") noexcept;
 
   void weights_info_string() noexcept;
+  void apply_large_pages() noexcept;
+  void apply_shared_hash() noexcept;
   void info_string(const search::search_worker& worker) noexcept;
 
   template <typename T, typename... Ts>
   void init_time_manager(Ts&&... args) noexcept;
+  void set_search_moves(const std::string& go_arguments) noexcept;
   void go() noexcept;
 
   void ponder_hit() noexcept;
@@ -75,10 +88,20 @@ struct uci {
   void ready() noexcept;
   void id_info() noexcept;
 
-  void bench() noexcept;
+  void bench(const std::string& args = std::string{}) noexcept;
+  void scale_bench(const std::string& args) noexcept;
+  void packed_board_bench() noexcept;
+  void datagen(const std::string& output_path, const std::size_t& num_games, const std::size_t& thread_count, const std::size_t& node_limit) noexcept;
+  void analyse(const std::string& input_path, const std::string& output_path, const analysis_limit& limit, const std::size_t& thread_count) noexcept;
   void eval() noexcept;
+  void eval_batch(const std::string& input_path, const std::string& output_path) noexcept;
   void probe() noexcept;
+  void tt_stats() noexcept;
+  void save_hash(const std::string& path) noexcept;
+  void load_hash(const std::string& path) noexcept;
   void perft(const search::depth_type& depth) noexcept;
+  void perft_divide(const search::depth_type& depth) noexcept;
+  void perft_suite(const std::string& input_path, const search::depth_type& max_depth) noexcept;
   void export_weights(const std::string& export_path) noexcept;
 
   void read(const std::string& line) noexcept;
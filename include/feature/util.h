@@ -25,7 +25,9 @@
 namespace feature::half_ka {
 
 constexpr std::size_t numel = 64 * 12 * 64;
-constexpr std::size_t max_active_half_features = 32;
+// one feature per occupied square. legal positions hold at most 32 pieces, but any parseable FEN
+// (as read by the bulk commands) may occupy every square.
+constexpr std::size_t max_active_half_features = 64;
 
 constexpr std::size_t major = 64 * 12;
 constexpr std::size_t minor = 64;
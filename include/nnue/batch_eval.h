@@ -0,0 +1,138 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chess/board.h>
+#include <chess/types.h>
+#include <nnue/aligned_vector.h>
+#include <nnue/eval.h>
+#include <nnue/feature_reset_cache.h>
+#include <nnue/weights.h>
+#include <search/search_constants.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace nnue {
+
+// static evaluation of many independent positions. positions are visited in order of their king
+// squares, so that each accumulator is built incrementally from the previous position sharing the
+// same king square through a feature_reset_cache. the dense layers are then applied layer by layer
+// over blocks of positions: fc1, fc2 and fc3 as matrix matrix products over the block, while fc0 remains
+// a matrix vector product per position, as its weights fit in L1 and the kernel is bound by maddubs
+// throughput. blocks are distributed over OpenMP threads in contiguous runs, each thread owning its own
+// reset cache.
+struct batch_eval {
+  static constexpr std::size_t block_size = 64;
+  static_assert(block_size <= eval::scratchpad_depth);
+
+  using parameter_type = eval::parameter_type;
+
+  using x1_type = aligned_vector<parameter_type, decltype(quantized_weights::fc0)::b_numel>;
+
+  // the outputs of fc0, fc1 and fc2 stacked in one feature major block, so that the concatenated inputs of
+  // fc1, fc2 and fc3 are leading rows of it
+  static constexpr std::size_t x1_dim = x1_type::dimension;
+  static constexpr std::size_t x2_dim = x1_dim + decltype(quantized_weights::fc1)::b_numel;
+  static constexpr std::size_t x3_dim = x2_dim + decltype(quantized_weights::fc2)::b_numel;
+
+  const quantized_weights* weights_;
+
+  template <bool pov>
+  void propagate_fc0_(const chess::board* boards, const std::size_t* order, const std::size_t& size, eval::scratchpad_type& scratchpad, x1_type* x1)
+      const noexcept {
+    const auto& fc0 = pov ? weights_->white_fc0 : weights_->black_fc0;
+
+    for (std::size_t i(0); i < size; ++i) {
+      if (boards[order[i]].turn() != pov) { continue; }
+      const auto base = scratchpad.get_nth_slice<eval::feature_transformer_dim>(i);
+      x1[i] = fc0.forward_crelu255(base).template dequantized<parameter_type>(weights::dequantization_scale);
+    }
+  }
+
+  void evaluate_block_(
+      const chess::board* boards,
+      const std::size_t* order,
+      const std::size_t& size,
+      sided_feature_reset_cache& reset_cache,
+      eval::scratchpad_type& scratchpad,
+      search::score_type* scores) const noexcept {
+    for (std::size_t i(0); i < size; ++i) {
+      eval accumulator(weights_, &scratchpad, i, i);
+      boards[order[i]].half_feature_refresh<chess::color::white>(reset_cache, accumulator);
+      boards[order[i]].half_feature_refresh<chess::color::black>(reset_cache, accumulator);
+    }
+
+    x1_type x1[block_size];
+
+    propagate_fc0_<true>(boards, order, size, scratchpad, x1);
+    propagate_fc0_<false>(boards, order, size, scratchpad, x1);
+
+    alignas(simd::alignment) parameter_type x3[x3_dim * block_size]{};
+    alignas(simd::alignment) parameter_type predictions[block_size];
+
+    for (std::size_t i(0); i < size; ++i) {
+      for (std::size_t j(0); j < x1_dim; ++j) { x3[j * block_size + i] = x1[i].data[j]; }
+    }
+
+    weights_->fc1.forward_relu_block<block_size>(x3, x3 + x1_dim * block_size);
+    weights_->fc2.forward_relu_block<block_size>(x3, x3 + x2_dim * block_size);
+    weights_->fc3.forward_relu_block<block_size>(x3, predictions);
+
+    for (std::size_t i(0); i < size; ++i) { scores[order[i]] = eval::score(predictions[i], boards[order[i]].phase<parameter_type>()); }
+  }
+
+  [[nodiscard]] std::vector<search::score_type> evaluate(const std::vector<chess::board>& boards) const noexcept {
+    std::vector<search::score_type> scores(boards.size());
+
+    std::vector<std::size_t> order(boards.size());
+    std::iota(order.begin(), order.end(), std::size_t{});
+
+    const auto king_key = [&boards](const std::size_t& i) {
+      const auto& man = boards[i].man_;
+      return man.white.king().item().index() * feature_reset_cache::num_squares + man.black.king().item().index();
+    };
+
+    std::stable_sort(order.begin(), order.end(), [&](const std::size_t& a, const std::size_t& b) { return king_key(a) < king_key(b); });
+
+    const std::size_t num_blocks = (boards.size() + block_size - 1) / block_size;
+
+#pragma omp parallel
+    {
+      auto reset_cache = std::make_unique<sided_feature_reset_cache>();
+      auto scratchpad = std::make_unique<eval::scratchpad_type>();
+      reset_cache->reinitialize(weights_);
+
+#pragma omp for schedule(static)
+      for (std::size_t block = 0; block < num_blocks; ++block) {
+        const std::size_t offset = block * block_size;
+        const std::size_t size = std::min(block_size, boards.size() - offset);
+        evaluate_block_(boards.data(), order.data() + offset, size, *reset_cache, *scratchpad, scores.data());
+      }
+    }
+
+    return scores;
+  }
+
+  explicit batch_eval(const quantized_weights* weights) noexcept : weights_{weights} {}
+};
+
+}  // namespace nnue
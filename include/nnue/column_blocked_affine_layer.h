@@ -0,0 +1,95 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <nnue/aligned_slice.h>
+#include <nnue/aligned_vector.h>
+#include <nnue/dense_relu_affine_layer.h>
+#include <nnue/dot_type.h>
+#include <nnue/simd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace nnue {
+
+// shared by all threads, so that evaluations made by search workers are visible to the thread
+// reporting the density. only the sparse path updates it, which is off by default.
+struct column_density_counter {
+  std::atomic<std::uint64_t> blocks{};
+  std::atomic<std::uint64_t> nonzero_blocks{};
+
+  [[nodiscard]] double density() const noexcept {
+    const std::uint64_t total = blocks.load(std::memory_order_relaxed);
+    return total == 0 ? 0.0 : static_cast<double>(nonzero_blocks.load(std::memory_order_relaxed)) / static_cast<double>(total);
+  }
+
+  void update(const std::uint64_t& num_blocks, const std::uint64_t& num_nonzero_blocks) noexcept {
+    blocks.fetch_add(num_blocks, std::memory_order_relaxed);
+    nonzero_blocks.fetch_add(num_nonzero_blocks, std::memory_order_relaxed);
+  }
+
+  void reset() noexcept {
+    blocks.store(0, std::memory_order_relaxed);
+    nonzero_blocks.store(0, std::memory_order_relaxed);
+  }
+};
+
+inline column_density_counter column_density{};
+
+// inference only copy of a dense layer with a column blocked weight layout. the weights
+// of simd::sparse_block_dim consecutive inputs for all outputs are contiguous, allowing
+// forward_crelu255 to skip input blocks which are zero after clamping.
+template <std::size_t dim0, std::size_t dim1, typename T, typename I = T, typename O = dot_type<I>>
+struct column_blocked_affine_layer {
+  static constexpr std::size_t block_dim = simd::sparse_block_dim;
+  static constexpr std::size_t num_blocks = dim0 / block_dim;
+  static_assert(dim0 % block_dim == 0);
+
+  static constexpr std::size_t W_numel = dim0 * dim1;
+  static constexpr std::size_t b_numel = dim1;
+
+  alignas(simd::alignment) T W[W_numel];
+  alignas(simd::alignment) O b[b_numel];
+
+  [[nodiscard]] inline aligned_vector<O, dim1> forward_crelu255(const aligned_slice<I, dim0>& x) const noexcept {
+    auto result = aligned_vector<O, dim1>::from(b);
+    const std::size_t nonzero_blocks = simd::sparse_crelu255_matrix_vector_product<dim0, dim1>(W, x.data, result.data);
+
+    column_density.update(num_blocks, nonzero_blocks);
+    return result;
+  }
+
+  [[nodiscard]] static column_blocked_affine_layer<dim0, dim1, T, I, O> from(const dense_relu_affine_layer<dim0, dim1, T, I, O>& dense) noexcept {
+    column_blocked_affine_layer<dim0, dim1, T, I, O> result{};
+
+    for (std::size_t block(0); block < num_blocks; ++block) {
+      for (std::size_t i(0); i < dim1; ++i) {
+        for (std::size_t k(0); k < block_dim; ++k) {
+          result.W[block * block_dim * dim1 + i * block_dim + k] = dense.W[i * dim0 + block * block_dim + k];
+        }
+      }
+    }
+
+    for (std::size_t i(0); i < b_numel; ++i) { result.b[i] = dense.b[i]; }
+    return result;
+  }
+};
+
+}  // namespace nnue
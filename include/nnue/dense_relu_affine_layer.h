@@ -49,6 +49,13 @@ struct dense_relu_affine_layer {
     return result;
   }
 
+  // forward_relu over a feature major block: input holds dim0 rows of block_dim values and output receives dim1 such rows
+  template <std::size_t block_dim>
+  inline void forward_relu_block(const I* input, O* output) const noexcept {
+    for (std::size_t i(0); i < dim1; ++i) { std::fill(output + i * block_dim, output + (i + 1) * block_dim, b[i]); }
+    simd::relu_matrix_matrix_product<dim0, dim1, block_dim>(W, input, output);
+  }
+
   [[nodiscard]] inline aligned_vector<O, dim1> forward_crelu255(const aligned_vector<I, dim0>& x) const noexcept {
     auto result = aligned_vector<O, dim1>::from(b);
     simd::crelu255_matrix_vector_product<dim0, dim1>(W, x.data, result.data);
@@ -24,7 +24,7 @@
 namespace nnue::embed {
 
 extern "C" {
-INCBIN(weights_file, EVALFILE);
+INCBIN_EXTERN(weights_file);
 }
 
 }  // namespace nnue::embed
@@ -90,7 +90,10 @@ struct eval : public chess::sided<eval, feature_transformer<weights::quantized_p
 
   template <typename F>
   [[nodiscard]] inline propagate_data<std::invoke_result_t<F, final_output_type>> propagate(const bool pov, F&& final_output_encoder) const noexcept {
-    const auto x1 = (pov ? weights_->white_fc0 : weights_->black_fc0).forward_crelu255(base_).dequantized<parameter_type>(weights::dequantization_scale);
+    const auto x0 = weights_->sparse_fc0 ? (pov ? weights_->white_blocked_fc0 : weights_->black_blocked_fc0).forward_crelu255(base_) :
+                                           (pov ? weights_->white_fc0 : weights_->black_fc0).forward_crelu255(base_);
+
+    const auto x1 = x0.dequantized<parameter_type>(weights::dequantization_scale);
     const auto x2 = concat(x1, weights_->fc1.forward_relu(x1));
     const auto x3 = concat(x2, weights_->fc2.forward_relu(x2));
     return propagate_data(final_output_encoder(x3), weights_->fc3.forward_relu(x3).item());
@@ -99,18 +102,21 @@ struct eval : public chess::sided<eval, feature_transformer<weights::quantized_p
   template <typename F = void_final_output_encoder>
   [[nodiscard]] inline evaluate_data<std::invoke_result_t<F, final_output_type>>
   evaluate(const bool pov, const parameter_type& phase, F&& final_output_encoder = void_final_output_encoder{}) const noexcept {
+    const auto [final_output_encoding, prediction] = propagate(pov, std::forward<F>(final_output_encoder));
+    return evaluate_data(final_output_encoding, score(prediction, phase));
+  }
+
+  [[nodiscard]] static inline search::score_type score(const parameter_type& prediction, const parameter_type& phase) noexcept {
     constexpr auto one = static_cast<parameter_type>(1.0);
     constexpr auto mg = static_cast<parameter_type>(0.7);
     constexpr auto eg = static_cast<parameter_type>(0.55);
 
-    const auto [final_output_encoding, prediction] = propagate(pov, std::forward<F>(final_output_encoder));
     const parameter_type eval = phase * mg * prediction + (one - phase) * eg * prediction;
 
     const parameter_type value =
         search::logit_scale<parameter_type> * std::clamp(eval, search::min_logit<parameter_type>, search::max_logit<parameter_type>);
 
-    const auto score = static_cast<search::score_type>(value);
-    return evaluate_data(final_output_encoding, score);
+    return static_cast<search::score_type>(value);
   }
 
   [[nodiscard]] eval next_child() const noexcept {
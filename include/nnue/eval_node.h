@@ -18,9 +18,13 @@
 
 #include <chess/board.h>
 #include <chess/move.h>
+#include <chess/types.h>
 #include <nnue/eval.h>
+#include <nnue/feature_delta.h>
 #include <nnue/feature_reset_cache.h>
 
+#include <cstddef>
+
 namespace nnue {
 
 struct eval_node {
@@ -38,17 +42,72 @@ struct eval_node {
     eval eval_;
   } data_;
 
+  // below this many pending feature updates, refreshing through the reset cache is not considered.
+  static constexpr std::size_t min_refresh_candidate_size = 8;
+
   [[nodiscard]] bool dirty() const noexcept { return dirty_; }
+  [[nodiscard]] bool has_dirty_parent_() const noexcept { return dirty_ && data_.context_.parent_node_->dirty(); }
 
   [[nodiscard]] const eval& evaluator() {
     if (!dirty_) { return data_.eval_; }
-    dirty_ = false;
     const context ctxt = data_.context_;
+
+    // a dirty parent is likely to be shared with siblings and is therefore materialized. when it
+    // has dirty ancestors of its own, the feature updates back to the nearest clean ancestor are
+    // gathered and applied in a single pass per perspective (the ancestors in between are left
+    // dirty and are only materialized if they are evaluated).
+    if (ctxt.parent_node_->has_dirty_parent_()) { ctxt.parent_node_->catch_up_(); }
+
+    dirty_ = false;
     data_.eval_ = ctxt.parent_node_->evaluator().next_child();
     ctxt.parent_board_->feature_move_delta(ctxt.move_, *ctxt.reset_cache_, data_.eval_);
     return data_.eval_;
   }
 
+  void catch_up_() noexcept {
+    const context ctxt = data_.context_;
+
+    sided_feature_delta deltas{};
+    std::size_t plies{0};
+    const eval& ancestor = replay_(deltas, plies);
+
+    dirty_ = false;
+    data_.eval_ = eval(ancestor.weights_, ancestor.scratchpad_, ancestor.scratchpad_idx_, ancestor.scratchpad_idx_ + plies);
+
+    const chess::board bd = ctxt.parent_board_->forward(ctxt.move_);
+    apply_<chess::color::white>(bd, *ctxt.reset_cache_, deltas);
+    apply_<chess::color::black>(bd, *ctxt.reset_cache_, deltas);
+  }
+
+  [[nodiscard]] const eval& replay_(sided_feature_delta& deltas, std::size_t& plies) const noexcept {
+    const context& ctxt = data_.context_;
+
+    const eval& ancestor = [&]() -> const eval& {
+      if (ctxt.parent_node_->dirty()) { return ctxt.parent_node_->replay_(deltas, plies); }
+
+      const eval& clean = ctxt.parent_node_->data_.eval_;
+      deltas.white.reset_to(&clean.weights_->shared, clean.white.slice_.data);
+      deltas.black.reset_to(&clean.weights_->shared, clean.black.slice_.data);
+      return clean;
+    }();
+
+    ctxt.parent_board_->feature_move_delta(ctxt.move_, *ctxt.reset_cache_, deltas);
+    ++plies;
+    return ancestor;
+  }
+
+  template <chess::color c>
+  void apply_(const chess::board& bd, sided_feature_reset_cache& reset_cache, const sided_feature_delta& deltas) noexcept {
+    const auto& delta = deltas.us<c>();
+    const bool refresh = delta.overflow() || (delta.size() >= min_refresh_candidate_size && bd.half_feature_refresh_cost<c>(reset_cache) + 1 < delta.size());
+
+    if (refresh) {
+      bd.half_feature_refresh<c>(reset_cache, data_.eval_);
+    } else {
+      delta.apply_to(data_.eval_.us<c>().slice_);
+    }
+  }
+
   [[nodiscard]] eval_node dirty_child(sided_feature_reset_cache* reset_cache, const chess::board* bd, const chess::move& mv) noexcept {
     return eval_node::dirty_node(context{reset_cache, this, bd, mv});
   }
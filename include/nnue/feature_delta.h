@@ -0,0 +1,105 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chess/types.h>
+#include <feature/util.h>
+#include <nnue/aligned_slice.h>
+#include <nnue/sparse_affine_layer.h>
+#include <nnue/weights.h>
+
+#include <cstddef>
+
+namespace nnue {
+
+// records the feature updates of several consecutive moves (exposing the same interface as
+// feature_transformer) so that they may later be applied to an accumulator in a single pass.
+// opposing insertions and erasures of the same feature cancel.
+template <typename T, std::size_t dim0, std::size_t dim1>
+struct feature_delta {
+  static constexpr std::size_t capacity = 32;
+
+  const sparse_affine_layer<T, dim0, dim1>* weights_{nullptr};
+  const T* src_{nullptr};
+
+  std::size_t num_inserts_{0};
+  std::size_t num_erases_{0};
+  bool overflow_{false};
+
+  std::size_t insert_idx_[capacity];
+  std::size_t erase_idx_[capacity];
+
+  [[nodiscard]] std::size_t size() const noexcept { return num_inserts_ + num_erases_; }
+  [[nodiscard]] bool overflow() const noexcept { return overflow_; }
+
+  void reset_to(const sparse_affine_layer<T, dim0, dim1>* weights, const T* src) noexcept {
+    weights_ = weights;
+    src_ = src;
+    num_inserts_ = num_erases_ = 0;
+    overflow_ = false;
+  }
+
+  void clear() noexcept { reset_to(weights_, weights_->b); }
+  void copy_from(const aligned_slice<T, dim1>& src) noexcept { reset_to(weights_, src.data); }
+
+  void insert(const std::size_t& idx) noexcept { push_or_cancel_(idx, insert_idx_, num_inserts_, erase_idx_, num_erases_); }
+  void erase(const std::size_t& idx) noexcept { push_or_cancel_(idx, erase_idx_, num_erases_, insert_idx_, num_inserts_); }
+
+  void clear_insert_many(const std::size_t* insert_idx, const std::size_t& num_inserts) noexcept {
+    clear();
+    for (std::size_t i(0); i < num_inserts; ++i) { insert(insert_idx[i]); }
+  }
+
+  void copy_parent_insert_erase(const std::size_t& insert_idx, const std::size_t& erase_idx) noexcept {
+    insert(insert_idx);
+    erase(erase_idx);
+  }
+
+  void copy_parent_insert_erase_erase(const std::size_t& insert_idx, const std::size_t& erase_idx_0, const std::size_t& erase_idx_1) noexcept {
+    insert(insert_idx);
+    erase(erase_idx_0);
+    erase(erase_idx_1);
+  }
+
+  void apply_to(aligned_slice<T, dim1> dst) const noexcept { weights_->insert_erase_many_idx(insert_idx_, num_inserts_, erase_idx_, num_erases_, src_, dst); }
+
+  void push_or_cancel_(const std::size_t& idx, std::size_t* same, std::size_t& num_same, std::size_t* opposing, std::size_t& num_opposing) noexcept {
+    for (std::size_t i(0); i < num_opposing; ++i) {
+      if (opposing[i] == idx) {
+        opposing[i] = opposing[--num_opposing];
+        return;
+      }
+    }
+
+    if (num_same == capacity) {
+      overflow_ = true;
+      return;
+    }
+
+    same[num_same++] = idx;
+  }
+};
+
+struct sided_feature_delta : public chess::sided<sided_feature_delta, feature_delta<weights::quantized_parameter_type, feature::half_ka::numel, weights::base_dim>> {
+  feature_delta<weights::quantized_parameter_type, feature::half_ka::numel, weights::base_dim> white;
+  feature_delta<weights::quantized_parameter_type, feature::half_ka::numel, weights::base_dim> black;
+
+  sided_feature_delta() noexcept : white{}, black{} {}
+};
+
+}  // namespace nnue
@@ -41,7 +41,16 @@ struct feature_reset_cache_entry {
 
   void insert(const std::size_t& idx) const noexcept { weights_->insert_idx(idx, slice_); }
   void erase(const std::size_t& idx) const noexcept { weights_->erase_idx(idx, slice_); }
-  void copy_state_to(feature_transformer<parameter_type, feature::half_ka::numel, dim>& dst) const noexcept { dst.slice_.copy_from(slice_); }
+
+  void insert_erase_many(const std::size_t* insert_idx, const std::size_t& num_inserts, const std::size_t* erase_idx, const std::size_t& num_erases)
+      const noexcept {
+    weights_->insert_erase_many_idx(insert_idx, num_inserts, erase_idx, num_erases, slice_.data, slice_);
+  }
+
+  template <typename T>
+  void copy_state_to(T& dst) const noexcept {
+    dst.copy_from(slice_);
+  }
 
   void reinitialize(const weights_type* weights, const aligned_slice<parameter_type, dim>& slice) noexcept {
     weights_ = weights;
@@ -44,9 +44,14 @@ struct feature_transformer {
 
   void clear() noexcept { slice_.copy_from(weights_->b); }
   void copy_parent() noexcept { slice_.copy_from(parent_slice_); }
+  void copy_from(const aligned_slice<T, dim1>& src) noexcept { slice_.copy_from(src); }
   void insert(const std::size_t& idx) noexcept { weights_->insert_idx(idx, slice_); }
   void erase(const std::size_t& idx) noexcept { weights_->erase_idx(idx, slice_); }
 
+  void clear_insert_many(const std::size_t* insert_idx, const std::size_t& num_inserts) noexcept {
+    weights_->insert_erase_many_idx(insert_idx, num_inserts, nullptr, 0, weights_->b, slice_);
+  }
+
   void copy_parent_insert_erase(const std::size_t& insert_idx, const std::size_t& erase_idx) noexcept {
     weights_->insert_erase_idx(insert_idx, erase_idx, parent_slice_, slice_);
   }
@@ -0,0 +1,74 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <string>
+
+namespace nnue {
+
+// read only mapping of an entire file. on platforms without mmap support the mapping
+// is never opened and callers are expected to fall back to stream based reading.
+struct mapped_file {
+  const unsigned char* data_{nullptr};
+  std::size_t size_{0};
+
+  [[nodiscard]] bool is_open() const noexcept { return data_ != nullptr; }
+  [[nodiscard]] const unsigned char* data() const noexcept { return data_; }
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  explicit mapped_file(const std::string& path) noexcept {
+#if !defined(_WIN32)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return; }
+
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+      const std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+      void* region = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (region != MAP_FAILED) {
+        data_ = static_cast<const unsigned char*>(region);
+        size_ = size;
+      }
+    }
+
+    ::close(fd);
+#else
+    static_cast<void>(path);
+#endif
+  }
+
+  ~mapped_file() noexcept {
+#if !defined(_WIN32)
+    if (data_ != nullptr) { ::munmap(const_cast<unsigned char*>(data_), size_); }
+#endif
+  }
+};
+
+}  // namespace nnue
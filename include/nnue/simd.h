@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 
@@ -43,6 +44,15 @@ inline void aligned_free(void* ptr) {
 #endif
 }
 
+#if defined(__AVX512BW__)
+struct vector_512 {
+  using integral_type = __m512i;
+  using float_type = __m512;
+  static_assert(sizeof(integral_type) == sizeof(float_type));
+  static constexpr std::size_t size = sizeof(integral_type);
+};
+#endif
+
 #if defined(__AVX2__)
 struct vector_256 {
   using integral_type = __m256i;
@@ -61,13 +71,23 @@ struct vector_128 {
 };
 #endif
 
-#if defined(__AVX2__)
+#if defined(__AVX512BW__)
+constexpr std::size_t alignment = vector_512::size;
+#if defined(__AVX512VNNI__)
+constexpr std::string_view instruction_set = "avx512vnni";
+#else
+constexpr std::string_view instruction_set = "avx512bw";
+#endif
+#elif defined(__AVX2__)
 constexpr std::size_t alignment = vector_256::size;
+constexpr std::string_view instruction_set = "avx2";
 #elif defined(__SSSE3__)
 constexpr std::size_t alignment = vector_128::size;
+constexpr std::string_view instruction_set = "ssse3";
 #else
 constexpr std::size_t default_alignment = 16;
 constexpr std::size_t alignment = default_alignment;
+constexpr std::string_view instruction_set = "generic";
 #endif
 
 template <typename vector_x, typename element_type>
@@ -123,6 +143,33 @@ inline void add_add_sub_sub(const T* a_0, const T* a_1, const T* s_0, const T* s
   for (std::size_t i = 0; i < dim; ++i) { out[i] = a_0[i] - s_0[i] + a_1[i] - s_1[i]; }
 }
 
+// out = src + sum of the add_idx rows of matrix - sum of the sub_idx rows of matrix. src and
+// out may alias.
+template <std::size_t dim, typename T>
+inline void add_sub_rows(
+    const T* matrix,
+    const T* src,
+    const std::size_t* add_idx,
+    const std::size_t& num_add,
+    const std::size_t* sub_idx,
+    const std::size_t& num_sub,
+    T* out) noexcept {
+#pragma omp simd
+  for (std::size_t i = 0; i < dim; ++i) { out[i] = src[i]; }
+
+  for (std::size_t j(0); j < num_add; ++j) {
+    const T* row = matrix + add_idx[j] * dim;
+#pragma omp simd
+    for (std::size_t i = 0; i < dim; ++i) { out[i] += row[i]; }
+  }
+
+  for (std::size_t j(0); j < num_sub; ++j) {
+    const T* row = matrix + sub_idx[j] * dim;
+#pragma omp simd
+    for (std::size_t i = 0; i < dim; ++i) { out[i] -= row[i]; }
+  }
+}
+
 template <std::size_t dim0, std::size_t dim1, typename T0, typename T1>
 inline void relu_matrix_vector_product(const T0* matrix, const T0* input, T1* output) noexcept {
 #pragma omp simd
@@ -139,6 +186,416 @@ inline void crelu255_matrix_vector_product(const T0* matrix, const T1* input, T2
   }
 }
 
+// sparse kernels consume a column blocked matrix: the weights of sparse_block_dim consecutive inputs
+// for all dim1 outputs are stored contiguously so that a block can be skipped when all of its
+// (crelu255 clamped) inputs are zero. they return the number of non-zero blocks.
+constexpr std::size_t sparse_block_dim = 4;
+
+struct nonzero_block_index_table {
+  static constexpr std::size_t mask_bits = 8;
+  static constexpr std::size_t num_masks = std::size_t{1} << mask_bits;
+
+  alignas(16) std::uint16_t data[num_masks][mask_bits]{};
+
+  constexpr nonzero_block_index_table() noexcept {
+    for (std::size_t mask(0); mask < num_masks; ++mask) {
+      std::size_t count(0);
+      for (std::size_t bit(0); bit < mask_bits; ++bit) {
+        if (mask & (std::size_t{1} << bit)) { data[mask][count++] = static_cast<std::uint16_t>(bit); }
+      }
+    }
+  }
+};
+
+inline constexpr nonzero_block_index_table nonzero_block_indices{};
+
+template <std::size_t dim0, std::size_t dim1, typename T0, typename T1, typename T2>
+inline std::size_t sparse_crelu255_matrix_vector_product(const T0* blocked_matrix, const T1* input, T2* output) noexcept {
+  std::size_t nonzero_blocks{};
+  for (std::size_t j = 0; j < dim0; j += sparse_block_dim) {
+    T2 block_input[sparse_block_dim];
+    bool is_nonzero = false;
+
+    for (std::size_t k = 0; k < sparse_block_dim; ++k) {
+      block_input[k] = static_cast<T2>(std::min(std::max(input[j + k], T1{0}), T1{255}));
+      is_nonzero |= block_input[k] != T2{0};
+    }
+
+    if (!is_nonzero) { continue; }
+    ++nonzero_blocks;
+
+    const T0* block = blocked_matrix + j * dim1;
+    for (std::size_t i = 0; i < dim1; ++i) {
+      for (std::size_t k = 0; k < sparse_block_dim; ++k) { output[i] += block_input[k] * static_cast<T2>(block[i * sparse_block_dim + k]); }
+    }
+  }
+
+  return nonzero_blocks;
+}
+
+#if defined(__AVX512BW__)
+// the int16 add/sub kernels load feature transformer rows unaligned since those rows may
+// be borrowed from a memory mapped weights file. accumulators are always aligned.
+template <std::size_t dim>
+struct int16_add_x128 {
+  static constexpr std::size_t num_units = 4;
+  static constexpr bool available = divides<dim, num_units * per_unit<vector_512, std::int16_t>>;
+
+  static inline void f(std::int16_t* a, const std::int16_t* b) noexcept {
+    for (std::size_t i(0); i < dim; i += num_units * per_unit<vector_512, std::int16_t>) {
+      __m512i* a_0 = (__m512i*)(a + i + 0 * per_unit<vector_512, std::int16_t>);
+      *a_0 = _mm512_add_epi16(*a_0, _mm512_loadu_si512((__m512i*)(b + i + 0 * per_unit<vector_512, std::int16_t>)));
+
+      __m512i* a_1 = (__m512i*)(a + i + 1 * per_unit<vector_512, std::int16_t>);
+      *a_1 = _mm512_add_epi16(*a_1, _mm512_loadu_si512((__m512i*)(b + i + 1 * per_unit<vector_512, std::int16_t>)));
+
+      __m512i* a_2 = (__m512i*)(a + i + 2 * per_unit<vector_512, std::int16_t>);
+      *a_2 = _mm512_add_epi16(*a_2, _mm512_loadu_si512((__m512i*)(b + i + 2 * per_unit<vector_512, std::int16_t>)));
+
+      __m512i* a_3 = (__m512i*)(a + i + 3 * per_unit<vector_512, std::int16_t>);
+      *a_3 = _mm512_add_epi16(*a_3, _mm512_loadu_si512((__m512i*)(b + i + 3 * per_unit<vector_512, std::int16_t>)));
+    }
+  }
+};
+
+template <std::size_t dim>
+struct int16_sub_x128 {
+  static constexpr std::size_t num_units = 4;
+  static constexpr bool available = divides<dim, num_units * per_unit<vector_512, std::int16_t>>;
+
+  static inline void f(std::int16_t* a, const std::int16_t* b) noexcept {
+    for (std::size_t i(0); i < dim; i += num_units * per_unit<vector_512, std::int16_t>) {
+      __m512i* a_0 = (__m512i*)(a + i + 0 * per_unit<vector_512, std::int16_t>);
+      *a_0 = _mm512_sub_epi16(*a_0, _mm512_loadu_si512((__m512i*)(b + i + 0 * per_unit<vector_512, std::int16_t>)));
+
+      __m512i* a_1 = (__m512i*)(a + i + 1 * per_unit<vector_512, std::int16_t>);
+      *a_1 = _mm512_sub_epi16(*a_1, _mm512_loadu_si512((__m512i*)(b + i + 1 * per_unit<vector_512, std::int16_t>)));
+
+      __m512i* a_2 = (__m512i*)(a + i + 2 * per_unit<vector_512, std::int16_t>);
+      *a_2 = _mm512_sub_epi16(*a_2, _mm512_loadu_si512((__m512i*)(b + i + 2 * per_unit<vector_512, std::int16_t>)));
+
+      __m512i* a_3 = (__m512i*)(a + i + 3 * per_unit<vector_512, std::int16_t>);
+      *a_3 = _mm512_sub_epi16(*a_3, _mm512_loadu_si512((__m512i*)(b + i + 3 * per_unit<vector_512, std::int16_t>)));
+    }
+  }
+};
+
+template <std::size_t dim>
+struct int16_add_add_sub_x128 {
+  static constexpr std::size_t num_units = 4;
+  static constexpr bool available = divides<dim, num_units * per_unit<vector_512, std::int16_t>>;
+
+  static inline void f(const std::int16_t* a_0, const std::int16_t* a_1, const std::int16_t* s_0, std::int16_t* out) noexcept {
+    for (std::size_t i(0); i < dim; i += num_units * per_unit<vector_512, std::int16_t>) {
+      {
+        const __m512i a_0_0 = _mm512_load_si512((__m512i*)(a_0 + i + 0 * per_unit<vector_512, std::int16_t>));
+        const __m512i a_1_0 = _mm512_loadu_si512((__m512i*)(a_1 + i + 0 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_0_0 = _mm512_loadu_si512((__m512i*)(s_0 + i + 0 * per_unit<vector_512, std::int16_t>));
+        __m512i* out_0 = (__m512i*)(out + i + 0 * per_unit<vector_512, std::int16_t>);
+        *out_0 = _mm512_add_epi16(a_0_0, _mm512_sub_epi16(a_1_0, s_0_0));
+      }
+
+      {
+        const __m512i a_0_1 = _mm512_load_si512((__m512i*)(a_0 + i + 1 * per_unit<vector_512, std::int16_t>));
+        const __m512i a_1_1 = _mm512_loadu_si512((__m512i*)(a_1 + i + 1 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_0_1 = _mm512_loadu_si512((__m512i*)(s_0 + i + 1 * per_unit<vector_512, std::int16_t>));
+        __m512i* out_1 = (__m512i*)(out + i + 1 * per_unit<vector_512, std::int16_t>);
+        *out_1 = _mm512_add_epi16(a_0_1, _mm512_sub_epi16(a_1_1, s_0_1));
+      }
+
+      {
+        const __m512i a_0_2 = _mm512_load_si512((__m512i*)(a_0 + i + 2 * per_unit<vector_512, std::int16_t>));
+        const __m512i a_1_2 = _mm512_loadu_si512((__m512i*)(a_1 + i + 2 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_0_2 = _mm512_loadu_si512((__m512i*)(s_0 + i + 2 * per_unit<vector_512, std::int16_t>));
+        __m512i* out_2 = (__m512i*)(out + i + 2 * per_unit<vector_512, std::int16_t>);
+        *out_2 = _mm512_add_epi16(a_0_2, _mm512_sub_epi16(a_1_2, s_0_2));
+      }
+
+      {
+        const __m512i a_0_3 = _mm512_load_si512((__m512i*)(a_0 + i + 3 * per_unit<vector_512, std::int16_t>));
+        const __m512i a_1_3 = _mm512_loadu_si512((__m512i*)(a_1 + i + 3 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_0_3 = _mm512_loadu_si512((__m512i*)(s_0 + i + 3 * per_unit<vector_512, std::int16_t>));
+        __m512i* out_3 = (__m512i*)(out + i + 3 * per_unit<vector_512, std::int16_t>);
+        *out_3 = _mm512_add_epi16(a_0_3, _mm512_sub_epi16(a_1_3, s_0_3));
+      }
+    }
+  }
+};
+
+template <std::size_t dim>
+struct int16_add_add_sub_sub_x128 {
+  static constexpr std::size_t num_units = 4;
+  static constexpr bool available = divides<dim, num_units * per_unit<vector_512, std::int16_t>>;
+
+  static inline void
+  f(const std::int16_t* a_0, const std::int16_t* a_1, const std::int16_t* s_0, const std::int16_t* s_1, std::int16_t* out) noexcept {
+    for (std::size_t i(0); i < dim; i += num_units * per_unit<vector_512, std::int16_t>) {
+      {
+        const __m512i a_0_0 = _mm512_load_si512((__m512i*)(a_0 + i + 0 * per_unit<vector_512, std::int16_t>));
+        const __m512i a_1_0 = _mm512_loadu_si512((__m512i*)(a_1 + i + 0 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_0_0 = _mm512_loadu_si512((__m512i*)(s_0 + i + 0 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_1_0 = _mm512_loadu_si512((__m512i*)(s_1 + i + 0 * per_unit<vector_512, std::int16_t>));
+        __m512i* out_0 = (__m512i*)(out + i + 0 * per_unit<vector_512, std::int16_t>);
+        *out_0 = _mm512_add_epi16(_mm512_sub_epi16(a_0_0, s_0_0), _mm512_sub_epi16(a_1_0, s_1_0));
+      }
+
+      {
+        const __m512i a_0_1 = _mm512_load_si512((__m512i*)(a_0 + i + 1 * per_unit<vector_512, std::int16_t>));
+        const __m512i a_1_1 = _mm512_loadu_si512((__m512i*)(a_1 + i + 1 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_0_1 = _mm512_loadu_si512((__m512i*)(s_0 + i + 1 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_1_1 = _mm512_loadu_si512((__m512i*)(s_1 + i + 1 * per_unit<vector_512, std::int16_t>));
+        __m512i* out_1 = (__m512i*)(out + i + 1 * per_unit<vector_512, std::int16_t>);
+        *out_1 = _mm512_add_epi16(_mm512_sub_epi16(a_0_1, s_0_1), _mm512_sub_epi16(a_1_1, s_1_1));
+      }
+
+      {
+        const __m512i a_0_2 = _mm512_load_si512((__m512i*)(a_0 + i + 2 * per_unit<vector_512, std::int16_t>));
+        const __m512i a_1_2 = _mm512_loadu_si512((__m512i*)(a_1 + i + 2 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_0_2 = _mm512_loadu_si512((__m512i*)(s_0 + i + 2 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_1_2 = _mm512_loadu_si512((__m512i*)(s_1 + i + 2 * per_unit<vector_512, std::int16_t>));
+        __m512i* out_2 = (__m512i*)(out + i + 2 * per_unit<vector_512, std::int16_t>);
+        *out_2 = _mm512_add_epi16(_mm512_sub_epi16(a_0_2, s_0_2), _mm512_sub_epi16(a_1_2, s_1_2));
+      }
+
+      {
+        const __m512i a_0_3 = _mm512_load_si512((__m512i*)(a_0 + i + 3 * per_unit<vector_512, std::int16_t>));
+        const __m512i a_1_3 = _mm512_loadu_si512((__m512i*)(a_1 + i + 3 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_0_3 = _mm512_loadu_si512((__m512i*)(s_0 + i + 3 * per_unit<vector_512, std::int16_t>));
+        const __m512i s_1_3 = _mm512_loadu_si512((__m512i*)(s_1 + i + 3 * per_unit<vector_512, std::int16_t>));
+        __m512i* out_3 = (__m512i*)(out + i + 3 * per_unit<vector_512, std::int16_t>);
+        *out_3 = _mm512_add_epi16(_mm512_sub_epi16(a_0_3, s_0_3), _mm512_sub_epi16(a_1_3, s_1_3));
+      }
+    }
+  }
+};
+
+template <std::size_t dim>
+struct int16_add_sub_rows_x512 {
+  static constexpr std::size_t num_units = 16;
+  static constexpr std::size_t tile_dim = num_units * per_unit<vector_512, std::int16_t>;
+  static constexpr bool available = divides<dim, tile_dim>;
+
+  static inline void
+  f(const std::int16_t* matrix,
+    const std::int16_t* src,
+    const std::size_t* add_idx,
+    const std::size_t& num_add,
+    const std::size_t* sub_idx,
+    const std::size_t& num_sub,
+    std::int16_t* out) noexcept {
+    for (std::size_t i(0); i < dim; i += tile_dim) {
+      __m512i tile[num_units];
+
+#pragma GCC unroll 16
+      for (std::size_t u = 0; u < num_units; ++u) { tile[u] = _mm512_load_si512((__m512i*)(src + i + u * per_unit<vector_512, std::int16_t>)); }
+
+      for (std::size_t j(0); j < num_add; ++j) {
+        const std::int16_t* row = matrix + add_idx[j] * dim + i;
+#pragma GCC unroll 16
+        for (std::size_t u = 0; u < num_units; ++u) {
+          tile[u] = _mm512_add_epi16(tile[u], _mm512_loadu_si512((__m512i*)(row + u * per_unit<vector_512, std::int16_t>)));
+        }
+      }
+
+      for (std::size_t j(0); j < num_sub; ++j) {
+        const std::int16_t* row = matrix + sub_idx[j] * dim + i;
+#pragma GCC unroll 16
+        for (std::size_t u = 0; u < num_units; ++u) {
+          tile[u] = _mm512_sub_epi16(tile[u], _mm512_loadu_si512((__m512i*)(row + u * per_unit<vector_512, std::int16_t>)));
+        }
+      }
+
+#pragma GCC unroll 16
+      for (std::size_t u = 0; u < num_units; ++u) { _mm512_store_si512((__m512i*)(out + i + u * per_unit<vector_512, std::int16_t>), tile[u]); }
+    }
+  }
+};
+
+template <std::size_t dim0, std::size_t dim1>
+struct int16_crelu255_matrix_vector_product_x64_x8 {
+  static constexpr std::size_t num_units = 8;
+  static constexpr bool available = divides<dim1, num_units> && divides<dim0, per_unit<vector_512, std::int8_t>>;
+
+  static inline __m512i mm512_maddubs_epi16_coalesced(const __m512i& a, const __m512i& b) {
+    return _mm512_madd_epi16(_mm512_set1_epi16(1), _mm512_maddubs_epi16(a, b));
+  }
+
+  // the maskz forms sidestep gcc 12's spurious -Wuninitialized on _mm512_undefined_epi32
+  static inline __m256i mm512_fold_epi32(const __m512i& a) {
+    return _mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0b1111, a, 0), _mm512_maskz_extracti64x4_epi64(0b1111, a, 1));
+  }
+
+  static inline void f(const std::int8_t* matrix, const std::int16_t* input, std::int32_t* output) noexcept {
+    const __m512i pack_order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+    __m256i* v_output = (__m256i*)output;
+    constexpr std::size_t output_step = num_units / per_unit<vector_256, std::int32_t>;
+    for (std::size_t i(0); i < dim1; i += num_units, v_output += output_step) {
+      __m512i sum_0 = _mm512_setzero_si512();
+      __m512i sum_1 = _mm512_setzero_si512();
+      __m512i sum_2 = _mm512_setzero_si512();
+      __m512i sum_3 = _mm512_setzero_si512();
+      __m512i sum_4 = _mm512_setzero_si512();
+      __m512i sum_5 = _mm512_setzero_si512();
+      __m512i sum_6 = _mm512_setzero_si512();
+      __m512i sum_7 = _mm512_setzero_si512();
+
+      for (std::size_t j(0); j < dim0; j += per_unit<vector_512, std::uint8_t>) {
+        const __m512i input_region_0 = _mm512_load_si512((__m512i*)(input + j + 0 * per_unit<vector_512, std::int16_t>));
+        const __m512i input_region_1 = _mm512_load_si512((__m512i*)(input + j + 1 * per_unit<vector_512, std::int16_t>));
+        const __m512i packed_input_region = _mm512_packus_epi16(input_region_0, input_region_1);
+        const __m512i input_region = _mm512_maskz_permutexvar_epi64(0b11111111, pack_order, packed_input_region);
+
+        sum_0 = _mm512_add_epi32(mm512_maddubs_epi16_coalesced(input_region, _mm512_load_si512((__m512i*)(matrix + (i + 0) * dim0 + j))), sum_0);
+        sum_1 = _mm512_add_epi32(mm512_maddubs_epi16_coalesced(input_region, _mm512_load_si512((__m512i*)(matrix + (i + 1) * dim0 + j))), sum_1);
+        sum_2 = _mm512_add_epi32(mm512_maddubs_epi16_coalesced(input_region, _mm512_load_si512((__m512i*)(matrix + (i + 2) * dim0 + j))), sum_2);
+        sum_3 = _mm512_add_epi32(mm512_maddubs_epi16_coalesced(input_region, _mm512_load_si512((__m512i*)(matrix + (i + 3) * dim0 + j))), sum_3);
+        sum_4 = _mm512_add_epi32(mm512_maddubs_epi16_coalesced(input_region, _mm512_load_si512((__m512i*)(matrix + (i + 4) * dim0 + j))), sum_4);
+        sum_5 = _mm512_add_epi32(mm512_maddubs_epi16_coalesced(input_region, _mm512_load_si512((__m512i*)(matrix + (i + 5) * dim0 + j))), sum_5);
+        sum_6 = _mm512_add_epi32(mm512_maddubs_epi16_coalesced(input_region, _mm512_load_si512((__m512i*)(matrix + (i + 6) * dim0 + j))), sum_6);
+        sum_7 = _mm512_add_epi32(mm512_maddubs_epi16_coalesced(input_region, _mm512_load_si512((__m512i*)(matrix + (i + 7) * dim0 + j))), sum_7);
+      }
+
+      const __m256i sum_0_folded = mm512_fold_epi32(sum_0);
+      const __m256i sum_1_folded = mm512_fold_epi32(sum_1);
+      const __m256i sum_2_folded = mm512_fold_epi32(sum_2);
+      const __m256i sum_3_folded = mm512_fold_epi32(sum_3);
+      const __m256i sum_4_folded = mm512_fold_epi32(sum_4);
+      const __m256i sum_5_folded = mm512_fold_epi32(sum_5);
+      const __m256i sum_6_folded = mm512_fold_epi32(sum_6);
+      const __m256i sum_7_folded = mm512_fold_epi32(sum_7);
+
+      const __m256i sum_01 = _mm256_hadd_epi32(sum_0_folded, sum_1_folded);
+      const __m256i sum_23 = _mm256_hadd_epi32(sum_2_folded, sum_3_folded);
+      const __m256i sum_45 = _mm256_hadd_epi32(sum_4_folded, sum_5_folded);
+      const __m256i sum_67 = _mm256_hadd_epi32(sum_6_folded, sum_7_folded);
+
+      const __m256i sum_0123 = _mm256_hadd_epi32(sum_01, sum_23);
+      const __m256i sum_4567 = _mm256_hadd_epi32(sum_45, sum_67);
+
+      const __m256i sum_01234567 =
+          _mm256_add_epi32(_mm256_permute2f128_si256(sum_0123, sum_4567, 0x20), _mm256_permute2f128_si256(sum_0123, sum_4567, 0x31));
+
+      *v_output = _mm256_add_epi32(*v_output, sum_01234567);
+    }
+  }
+};
+
+#if defined(__AVX512VNNI__)
+// dpbusd would skip the int16 saturation of maddubs (2 * 255 * 127 exceeds the int16 range), making
+// evaluations depend on the host. so the pairs are still formed with maddubs, and dpwssd fuses only
+// the widening multiply by one and the accumulation, matching the avx512bw kernel bit for bit.
+template <std::size_t dim0, std::size_t dim1>
+struct int16_crelu255_matrix_vector_product_x64_x8_vnni {
+  static constexpr std::size_t num_units = 8;
+  static constexpr bool available = divides<dim1, num_units> && divides<dim0, per_unit<vector_512, std::int8_t>>;
+
+  static inline __m512i mm512_dpbusd_epi32_saturated(const __m512i& sum, const __m512i& a, const __m512i& b) {
+    return _mm512_dpwssd_epi32(sum, _mm512_maddubs_epi16(a, b), _mm512_set1_epi16(1));
+  }
+
+  // the maskz forms sidestep gcc 12's spurious -Wuninitialized on _mm512_undefined_epi32
+  static inline __m256i mm512_fold_epi32(const __m512i& a) {
+    return _mm256_add_epi32(_mm512_maskz_extracti64x4_epi64(0b1111, a, 0), _mm512_maskz_extracti64x4_epi64(0b1111, a, 1));
+  }
+
+  static inline void f(const std::int8_t* matrix, const std::int16_t* input, std::int32_t* output) noexcept {
+    const __m512i pack_order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+    __m256i* v_output = (__m256i*)output;
+    constexpr std::size_t output_step = num_units / per_unit<vector_256, std::int32_t>;
+    for (std::size_t i(0); i < dim1; i += num_units, v_output += output_step) {
+      __m512i sum_0 = _mm512_setzero_si512();
+      __m512i sum_1 = _mm512_setzero_si512();
+      __m512i sum_2 = _mm512_setzero_si512();
+      __m512i sum_3 = _mm512_setzero_si512();
+      __m512i sum_4 = _mm512_setzero_si512();
+      __m512i sum_5 = _mm512_setzero_si512();
+      __m512i sum_6 = _mm512_setzero_si512();
+      __m512i sum_7 = _mm512_setzero_si512();
+
+      for (std::size_t j(0); j < dim0; j += per_unit<vector_512, std::uint8_t>) {
+        const __m512i input_region_0 = _mm512_load_si512((__m512i*)(input + j + 0 * per_unit<vector_512, std::int16_t>));
+        const __m512i input_region_1 = _mm512_load_si512((__m512i*)(input + j + 1 * per_unit<vector_512, std::int16_t>));
+        const __m512i packed_input_region = _mm512_packus_epi16(input_region_0, input_region_1);
+        const __m512i input_region = _mm512_maskz_permutexvar_epi64(0b11111111, pack_order, packed_input_region);
+
+        sum_0 = mm512_dpbusd_epi32_saturated(sum_0, input_region, _mm512_load_si512((__m512i*)(matrix + (i + 0) * dim0 + j)));
+        sum_1 = mm512_dpbusd_epi32_saturated(sum_1, input_region, _mm512_load_si512((__m512i*)(matrix + (i + 1) * dim0 + j)));
+        sum_2 = mm512_dpbusd_epi32_saturated(sum_2, input_region, _mm512_load_si512((__m512i*)(matrix + (i + 2) * dim0 + j)));
+        sum_3 = mm512_dpbusd_epi32_saturated(sum_3, input_region, _mm512_load_si512((__m512i*)(matrix + (i + 3) * dim0 + j)));
+        sum_4 = mm512_dpbusd_epi32_saturated(sum_4, input_region, _mm512_load_si512((__m512i*)(matrix + (i + 4) * dim0 + j)));
+        sum_5 = mm512_dpbusd_epi32_saturated(sum_5, input_region, _mm512_load_si512((__m512i*)(matrix + (i + 5) * dim0 + j)));
+        sum_6 = mm512_dpbusd_epi32_saturated(sum_6, input_region, _mm512_load_si512((__m512i*)(matrix + (i + 6) * dim0 + j)));
+        sum_7 = mm512_dpbusd_epi32_saturated(sum_7, input_region, _mm512_load_si512((__m512i*)(matrix + (i + 7) * dim0 + j)));
+      }
+
+      const __m256i sum_0_folded = mm512_fold_epi32(sum_0);
+      const __m256i sum_1_folded = mm512_fold_epi32(sum_1);
+      const __m256i sum_2_folded = mm512_fold_epi32(sum_2);
+      const __m256i sum_3_folded = mm512_fold_epi32(sum_3);
+      const __m256i sum_4_folded = mm512_fold_epi32(sum_4);
+      const __m256i sum_5_folded = mm512_fold_epi32(sum_5);
+      const __m256i sum_6_folded = mm512_fold_epi32(sum_6);
+      const __m256i sum_7_folded = mm512_fold_epi32(sum_7);
+
+      const __m256i sum_01 = _mm256_hadd_epi32(sum_0_folded, sum_1_folded);
+      const __m256i sum_23 = _mm256_hadd_epi32(sum_2_folded, sum_3_folded);
+      const __m256i sum_45 = _mm256_hadd_epi32(sum_4_folded, sum_5_folded);
+      const __m256i sum_67 = _mm256_hadd_epi32(sum_6_folded, sum_7_folded);
+
+      const __m256i sum_0123 = _mm256_hadd_epi32(sum_01, sum_23);
+      const __m256i sum_4567 = _mm256_hadd_epi32(sum_45, sum_67);
+
+      const __m256i sum_01234567 =
+          _mm256_add_epi32(_mm256_permute2f128_si256(sum_0123, sum_4567, 0x20), _mm256_permute2f128_si256(sum_0123, sum_4567, 0x31));
+
+      *v_output = _mm256_add_epi32(*v_output, sum_01234567);
+    }
+  }
+};
+#endif
+
+template <std::size_t dim0>
+struct int16_crelu255_nonzero_blocks_x64 {
+  static constexpr bool available = divides<dim0, per_unit<vector_512, std::uint8_t>>;
+  static constexpr std::size_t num_blocks = dim0 / sparse_block_dim;
+  static constexpr std::size_t index_slack = nonzero_block_index_table::mask_bits;
+
+  alignas(vector_512::size) std::uint8_t packed[dim0];
+  alignas(vector_512::size) std::uint16_t indices[num_blocks + index_slack];
+  std::size_t count;
+
+  inline explicit int16_crelu255_nonzero_blocks_x64(const std::int16_t* input) noexcept : count{0} {
+    static_assert(per_unit<vector_512, std::int32_t> == 2 * nonzero_block_index_table::mask_bits);
+
+    const __m512i pack_order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m128i index_step = _mm_set1_epi16(nonzero_block_index_table::mask_bits);
+    __m128i index_base = _mm_setzero_si128();
+
+    for (std::size_t j(0); j < dim0; j += per_unit<vector_512, std::uint8_t>) {
+      const __m512i input_region_0 = _mm512_load_si512((__m512i*)(input + j + 0 * per_unit<vector_512, std::int16_t>));
+      const __m512i input_region_1 = _mm512_load_si512((__m512i*)(input + j + 1 * per_unit<vector_512, std::int16_t>));
+      const __m512i packed_input_region = _mm512_packus_epi16(input_region_0, input_region_1);
+      const __m512i input_region = _mm512_maskz_permutexvar_epi64(0b11111111, pack_order, packed_input_region);
+      _mm512_store_si512((__m512i*)(packed + j), input_region);
+
+      const unsigned nonzero_mask = _mm512_test_epi32_mask(input_region, input_region);
+      const unsigned nonzero_mask_lo = nonzero_mask & 0xFF;
+      const unsigned nonzero_mask_hi = nonzero_mask >> nonzero_block_index_table::mask_bits;
+
+      const __m128i block_indices_lo = _mm_load_si128((__m128i*)nonzero_block_indices.data[nonzero_mask_lo]);
+      _mm_storeu_si128((__m128i*)(indices + count), _mm_add_epi16(index_base, block_indices_lo));
+      count += static_cast<std::size_t>(__builtin_popcount(nonzero_mask_lo));
+      index_base = _mm_add_epi16(index_base, index_step);
+
+      const __m128i block_indices_hi = _mm_load_si128((__m128i*)nonzero_block_indices.data[nonzero_mask_hi]);
+      _mm_storeu_si128((__m128i*)(indices + count), _mm_add_epi16(index_base, block_indices_hi));
+      count += static_cast<std::size_t>(__builtin_popcount(nonzero_mask_hi));
+      index_base = _mm_add_epi16(index_base, index_step);
+    }
+  }
+};
+#endif
+
 #if defined(__AVX2__)
 template <std::size_t dim>
 struct int16_add_x64 {
@@ -148,23 +605,27 @@ struct int16_add_x64 {
   static inline void f(std::int16_t* a, const std::int16_t* b) noexcept {
     for (std::size_t i(0); i < dim; i += num_units * per_unit<vector_256, std::int16_t>) {
       __m256i* a_0 = (__m256i*)(a + i + 0 * per_unit<vector_256, std::int16_t>);
-      *a_0 = _mm256_add_epi16(*a_0, _mm256_load_si256((__m256i*)(b + i + 0 * per_unit<vector_256, std::int16_t>)));
+      *a_0 = _mm256_add_epi16(*a_0, _mm256_loadu_si256((__m256i*)(b + i + 0 * per_unit<vector_256, std::int16_t>)));
 
       __m256i* a_1 = (__m256i*)(a + i + 1 * per_unit<vector_256, std::int16_t>);
-      *a_1 = _mm256_add_epi16(*a_1, _mm256_load_si256((__m256i*)(b + i + 1 * per_unit<vector_256, std::int16_t>)));
+      *a_1 = _mm256_add_epi16(*a_1, _mm256_loadu_si256((__m256i*)(b + i + 1 * per_unit<vector_256, std::int16_t>)));
 
       __m256i* a_2 = (__m256i*)(a + i + 2 * per_unit<vector_256, std::int16_t>);
-      *a_2 = _mm256_add_epi16(*a_2, _mm256_load_si256((__m256i*)(b + i + 2 * per_unit<vector_256, std::int16_t>)));
+      *a_2 = _mm256_add_epi16(*a_2, _mm256_loadu_si256((__m256i*)(b + i + 2 * per_unit<vector_256, std::int16_t>)));
 
       __m256i* a_3 = (__m256i*)(a + i + 3 * per_unit<vector_256, std::int16_t>);
-      *a_3 = _mm256_add_epi16(*a_3, _mm256_load_si256((__m256i*)(b + i + 3 * per_unit<vector_256, std::int16_t>)));
+      *a_3 = _mm256_add_epi16(*a_3, _mm256_loadu_si256((__m256i*)(b + i + 3 * per_unit<vector_256, std::int16_t>)));
     }
   }
 };
 
 template <std::size_t dim>
 inline void add(std::int16_t* a, const std::int16_t* b) noexcept {
+#if defined(__AVX512BW__)
+  return overload_set<int16_add_x128<dim>, int16_add_x64<dim>>::f(a, b);
+#else
   return overload_set<int16_add_x64<dim>>::f(a, b);
+#endif
 }
 
 template <std::size_t dim>
@@ -175,23 +636,27 @@ struct int16_sub_x64 {
   static inline void f(std::int16_t* a, const std::int16_t* b) noexcept {
     for (std::size_t i(0); i < dim; i += num_units * per_unit<vector_256, std::int16_t>) {
       __m256i* a_0 = (__m256i*)(a + i + 0 * per_unit<vector_256, std::int16_t>);
-      *a_0 = _mm256_sub_epi16(*a_0, _mm256_load_si256((__m256i*)(b + i + 0 * per_unit<vector_256, std::int16_t>)));
+      *a_0 = _mm256_sub_epi16(*a_0, _mm256_loadu_si256((__m256i*)(b + i + 0 * per_unit<vector_256, std::int16_t>)));
 
       __m256i* a_1 = (__m256i*)(a + i + 1 * per_unit<vector_256, std::int16_t>);
-      *a_1 = _mm256_sub_epi16(*a_1, _mm256_load_si256((__m256i*)(b + i + 1 * per_unit<vector_256, std::int16_t>)));
+      *a_1 = _mm256_sub_epi16(*a_1, _mm256_loadu_si256((__m256i*)(b + i + 1 * per_unit<vector_256, std::int16_t>)));
 
       __m256i* a_2 = (__m256i*)(a + i + 2 * per_unit<vector_256, std::int16_t>);
-      *a_2 = _mm256_sub_epi16(*a_2, _mm256_load_si256((__m256i*)(b + i + 2 * per_unit<vector_256, std::int16_t>)));
+      *a_2 = _mm256_sub_epi16(*a_2, _mm256_loadu_si256((__m256i*)(b + i + 2 * per_unit<vector_256, std::int16_t>)));
 
       __m256i* a_3 = (__m256i*)(a + i + 3 * per_unit<vector_256, std::int16_t>);
-      *a_3 = _mm256_sub_epi16(*a_3, _mm256_load_si256((__m256i*)(b + i + 3 * per_unit<vector_256, std::int16_t>)));
+      *a_3 = _mm256_sub_epi16(*a_3, _mm256_loadu_si256((__m256i*)(b + i + 3 * per_unit<vector_256, std::int16_t>)));
     }
   }
 };
 
 template <std::size_t dim>
 inline void sub(std::int16_t* a, const std::int16_t* b) noexcept {
+#if defined(__AVX512BW__)
+  return overload_set<int16_sub_x128<dim>, int16_sub_x64<dim>>::f(a, b);
+#else
   return overload_set<int16_sub_x64<dim>>::f(a, b);
+#endif
 }
 
 template <std::size_t dim>
@@ -203,32 +668,32 @@ struct int16_add_add_sub_x64 {
     for (std::size_t i(0); i < dim; i += num_units * per_unit<vector_256, std::int16_t>) {
       {
         const __m256i a_0_0 = _mm256_load_si256((__m256i*)(a_0 + i + 0 * per_unit<vector_256, std::int16_t>));
-        const __m256i a_1_0 = _mm256_load_si256((__m256i*)(a_1 + i + 0 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_0_0 = _mm256_load_si256((__m256i*)(s_0 + i + 0 * per_unit<vector_256, std::int16_t>));
+        const __m256i a_1_0 = _mm256_loadu_si256((__m256i*)(a_1 + i + 0 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_0_0 = _mm256_loadu_si256((__m256i*)(s_0 + i + 0 * per_unit<vector_256, std::int16_t>));
         __m256i* out_0 = (__m256i*)(out + i + 0 * per_unit<vector_256, std::int16_t>);
         *out_0 = _mm256_add_epi16(a_0_0, _mm256_sub_epi16(a_1_0, s_0_0));
       }
 
       {
         const __m256i a_0_1 = _mm256_load_si256((__m256i*)(a_0 + i + 1 * per_unit<vector_256, std::int16_t>));
-        const __m256i a_1_1 = _mm256_load_si256((__m256i*)(a_1 + i + 1 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_0_1 = _mm256_load_si256((__m256i*)(s_0 + i + 1 * per_unit<vector_256, std::int16_t>));
+        const __m256i a_1_1 = _mm256_loadu_si256((__m256i*)(a_1 + i + 1 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_0_1 = _mm256_loadu_si256((__m256i*)(s_0 + i + 1 * per_unit<vector_256, std::int16_t>));
         __m256i* out_1 = (__m256i*)(out + i + 1 * per_unit<vector_256, std::int16_t>);
         *out_1 = _mm256_add_epi16(a_0_1, _mm256_sub_epi16(a_1_1, s_0_1));
       }
 
       {
         const __m256i a_0_2 = _mm256_load_si256((__m256i*)(a_0 + i + 2 * per_unit<vector_256, std::int16_t>));
-        const __m256i a_1_2 = _mm256_load_si256((__m256i*)(a_1 + i + 2 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_0_2 = _mm256_load_si256((__m256i*)(s_0 + i + 2 * per_unit<vector_256, std::int16_t>));
+        const __m256i a_1_2 = _mm256_loadu_si256((__m256i*)(a_1 + i + 2 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_0_2 = _mm256_loadu_si256((__m256i*)(s_0 + i + 2 * per_unit<vector_256, std::int16_t>));
         __m256i* out_2 = (__m256i*)(out + i + 2 * per_unit<vector_256, std::int16_t>);
         *out_2 = _mm256_add_epi16(a_0_2, _mm256_sub_epi16(a_1_2, s_0_2));
       }
 
       {
         const __m256i a_0_3 = _mm256_load_si256((__m256i*)(a_0 + i + 3 * per_unit<vector_256, std::int16_t>));
-        const __m256i a_1_3 = _mm256_load_si256((__m256i*)(a_1 + i + 3 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_0_3 = _mm256_load_si256((__m256i*)(s_0 + i + 3 * per_unit<vector_256, std::int16_t>));
+        const __m256i a_1_3 = _mm256_loadu_si256((__m256i*)(a_1 + i + 3 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_0_3 = _mm256_loadu_si256((__m256i*)(s_0 + i + 3 * per_unit<vector_256, std::int16_t>));
         __m256i* out_3 = (__m256i*)(out + i + 3 * per_unit<vector_256, std::int16_t>);
         *out_3 = _mm256_add_epi16(a_0_3, _mm256_sub_epi16(a_1_3, s_0_3));
       }
@@ -238,7 +703,11 @@ struct int16_add_add_sub_x64 {
 
 template <std::size_t dim>
 inline void add_add_sub(const std::int16_t* a_0, const std::int16_t* a_1, const std::int16_t* s_0, std::int16_t* out) {
+#if defined(__AVX512BW__)
+  return overload_set<int16_add_add_sub_x128<dim>, int16_add_add_sub_x64<dim>>::f(a_0, a_1, s_0, out);
+#else
   return overload_set<int16_add_add_sub_x64<dim>>::f(a_0, a_1, s_0, out);
+#endif
 }
 
 template <std::size_t dim>
@@ -251,36 +720,36 @@ struct int16_add_add_sub_sub_x64 {
     for (std::size_t i(0); i < dim; i += num_units * per_unit<vector_256, std::int16_t>) {
       {
         const __m256i a_0_0 = _mm256_load_si256((__m256i*)(a_0 + i + 0 * per_unit<vector_256, std::int16_t>));
-        const __m256i a_1_0 = _mm256_load_si256((__m256i*)(a_1 + i + 0 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_0_0 = _mm256_load_si256((__m256i*)(s_0 + i + 0 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_1_0 = _mm256_load_si256((__m256i*)(s_1 + i + 0 * per_unit<vector_256, std::int16_t>));
+        const __m256i a_1_0 = _mm256_loadu_si256((__m256i*)(a_1 + i + 0 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_0_0 = _mm256_loadu_si256((__m256i*)(s_0 + i + 0 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_1_0 = _mm256_loadu_si256((__m256i*)(s_1 + i + 0 * per_unit<vector_256, std::int16_t>));
         __m256i* out_0 = (__m256i*)(out + i + 0 * per_unit<vector_256, std::int16_t>);
         *out_0 = _mm256_add_epi16(_mm256_sub_epi16(a_0_0, s_0_0), _mm256_sub_epi16(a_1_0, s_1_0));
       }
 
       {
         const __m256i a_0_1 = _mm256_load_si256((__m256i*)(a_0 + i + 1 * per_unit<vector_256, std::int16_t>));
-        const __m256i a_1_1 = _mm256_load_si256((__m256i*)(a_1 + i + 1 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_0_1 = _mm256_load_si256((__m256i*)(s_0 + i + 1 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_1_1 = _mm256_load_si256((__m256i*)(s_1 + i + 1 * per_unit<vector_256, std::int16_t>));
+        const __m256i a_1_1 = _mm256_loadu_si256((__m256i*)(a_1 + i + 1 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_0_1 = _mm256_loadu_si256((__m256i*)(s_0 + i + 1 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_1_1 = _mm256_loadu_si256((__m256i*)(s_1 + i + 1 * per_unit<vector_256, std::int16_t>));
         __m256i* out_1 = (__m256i*)(out + i + 1 * per_unit<vector_256, std::int16_t>);
         *out_1 = _mm256_add_epi16(_mm256_sub_epi16(a_0_1, s_0_1), _mm256_sub_epi16(a_1_1, s_1_1));
       }
 
       {
         const __m256i a_0_2 = _mm256_load_si256((__m256i*)(a_0 + i + 2 * per_unit<vector_256, std::int16_t>));
-        const __m256i a_1_2 = _mm256_load_si256((__m256i*)(a_1 + i + 2 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_0_2 = _mm256_load_si256((__m256i*)(s_0 + i + 2 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_1_2 = _mm256_load_si256((__m256i*)(s_1 + i + 2 * per_unit<vector_256, std::int16_t>));
+        const __m256i a_1_2 = _mm256_loadu_si256((__m256i*)(a_1 + i + 2 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_0_2 = _mm256_loadu_si256((__m256i*)(s_0 + i + 2 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_1_2 = _mm256_loadu_si256((__m256i*)(s_1 + i + 2 * per_unit<vector_256, std::int16_t>));
         __m256i* out_2 = (__m256i*)(out + i + 2 * per_unit<vector_256, std::int16_t>);
         *out_2 = _mm256_add_epi16(_mm256_sub_epi16(a_0_2, s_0_2), _mm256_sub_epi16(a_1_2, s_1_2));
       }
 
       {
         const __m256i a_0_3 = _mm256_load_si256((__m256i*)(a_0 + i + 3 * per_unit<vector_256, std::int16_t>));
-        const __m256i a_1_3 = _mm256_load_si256((__m256i*)(a_1 + i + 3 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_0_3 = _mm256_load_si256((__m256i*)(s_0 + i + 3 * per_unit<vector_256, std::int16_t>));
-        const __m256i s_1_3 = _mm256_load_si256((__m256i*)(s_1 + i + 3 * per_unit<vector_256, std::int16_t>));
+        const __m256i a_1_3 = _mm256_loadu_si256((__m256i*)(a_1 + i + 3 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_0_3 = _mm256_loadu_si256((__m256i*)(s_0 + i + 3 * per_unit<vector_256, std::int16_t>));
+        const __m256i s_1_3 = _mm256_loadu_si256((__m256i*)(s_1 + i + 3 * per_unit<vector_256, std::int16_t>));
         __m256i* out_3 = (__m256i*)(out + i + 3 * per_unit<vector_256, std::int16_t>);
         *out_3 = _mm256_add_epi16(_mm256_sub_epi16(a_0_3, s_0_3), _mm256_sub_epi16(a_1_3, s_1_3));
       }
@@ -291,7 +760,69 @@ struct int16_add_add_sub_sub_x64 {
 template <std::size_t dim>
 inline void
 add_add_sub_sub(const std::int16_t* a_0, const std::int16_t* a_1, const std::int16_t* s_0, const std::int16_t* s_1, std::int16_t* out) noexcept {
+#if defined(__AVX512BW__)
+  return overload_set<int16_add_add_sub_sub_x128<dim>, int16_add_add_sub_sub_x64<dim>>::f(a_0, a_1, s_0, s_1, out);
+#else
   return overload_set<int16_add_add_sub_sub_x64<dim>>::f(a_0, a_1, s_0, s_1, out);
+#endif
+}
+
+template <std::size_t dim>
+struct int16_add_sub_rows_x256 {
+  static constexpr std::size_t num_units = 16;
+  static constexpr std::size_t tile_dim = num_units * per_unit<vector_256, std::int16_t>;
+  static constexpr bool available = divides<dim, tile_dim>;
+
+  static inline void
+  f(const std::int16_t* matrix,
+    const std::int16_t* src,
+    const std::size_t* add_idx,
+    const std::size_t& num_add,
+    const std::size_t* sub_idx,
+    const std::size_t& num_sub,
+    std::int16_t* out) noexcept {
+    for (std::size_t i(0); i < dim; i += tile_dim) {
+      __m256i tile[num_units];
+
+#pragma GCC unroll 16
+      for (std::size_t u = 0; u < num_units; ++u) { tile[u] = _mm256_load_si256((__m256i*)(src + i + u * per_unit<vector_256, std::int16_t>)); }
+
+      for (std::size_t j(0); j < num_add; ++j) {
+        const std::int16_t* row = matrix + add_idx[j] * dim + i;
+#pragma GCC unroll 16
+        for (std::size_t u = 0; u < num_units; ++u) {
+          tile[u] = _mm256_add_epi16(tile[u], _mm256_loadu_si256((__m256i*)(row + u * per_unit<vector_256, std::int16_t>)));
+        }
+      }
+
+      for (std::size_t j(0); j < num_sub; ++j) {
+        const std::int16_t* row = matrix + sub_idx[j] * dim + i;
+#pragma GCC unroll 16
+        for (std::size_t u = 0; u < num_units; ++u) {
+          tile[u] = _mm256_sub_epi16(tile[u], _mm256_loadu_si256((__m256i*)(row + u * per_unit<vector_256, std::int16_t>)));
+        }
+      }
+
+#pragma GCC unroll 16
+      for (std::size_t u = 0; u < num_units; ++u) { _mm256_store_si256((__m256i*)(out + i + u * per_unit<vector_256, std::int16_t>), tile[u]); }
+    }
+  }
+};
+
+template <std::size_t dim>
+inline void add_sub_rows(
+    const std::int16_t* matrix,
+    const std::int16_t* src,
+    const std::size_t* add_idx,
+    const std::size_t& num_add,
+    const std::size_t* sub_idx,
+    const std::size_t& num_sub,
+    std::int16_t* out) noexcept {
+#if defined(__AVX512BW__)
+  return overload_set<int16_add_sub_rows_x512<dim>, int16_add_sub_rows_x256<dim>>::f(matrix, src, add_idx, num_add, sub_idx, num_sub, out);
+#else
+  return overload_set<int16_add_sub_rows_x256<dim>>::f(matrix, src, add_idx, num_add, sub_idx, num_sub, out);
+#endif
 }
 
 template <std::size_t dim0, std::size_t dim1>
@@ -424,7 +955,170 @@ inline void relu_matrix_vector_product(const float* matrix, const float* input,
 
 template <std::size_t dim0, std::size_t dim1>
 inline void crelu255_matrix_vector_product(const std::int8_t* matrix, const std::int16_t* input, std::int32_t* output) noexcept {
+#if defined(__AVX512VNNI__)
+  return overload_set<
+      int16_crelu255_matrix_vector_product_x64_x8_vnni<dim0, dim1>,
+      int16_crelu255_matrix_vector_product_x64_x8<dim0, dim1>,
+      int16_crelu255_matrix_vector_product_x32_x8<dim0, dim1>>::f(matrix, input, output);
+#elif defined(__AVX512BW__)
+  return overload_set<int16_crelu255_matrix_vector_product_x64_x8<dim0, dim1>, int16_crelu255_matrix_vector_product_x32_x8<dim0, dim1>>::f(
+      matrix, input, output);
+#else
   return overload_set<int16_crelu255_matrix_vector_product_x32_x8<dim0, dim1>>::f(matrix, input, output);
+#endif
+}
+
+template <std::size_t dim0>
+struct int16_crelu255_nonzero_blocks_x32 {
+  static constexpr bool available = divides<dim0, per_unit<vector_256, std::uint8_t>>;
+  static constexpr std::size_t num_blocks = dim0 / sparse_block_dim;
+  static constexpr std::size_t index_slack = nonzero_block_index_table::mask_bits;
+
+  alignas(vector_256::size) std::uint8_t packed[dim0];
+  alignas(vector_256::size) std::uint16_t indices[num_blocks + index_slack];
+  std::size_t count;
+
+  inline explicit int16_crelu255_nonzero_blocks_x32(const std::int16_t* input) noexcept : count{0} {
+    static_assert(per_unit<vector_256, std::int32_t> == nonzero_block_index_table::mask_bits);
+
+    const __m256i zero = _mm256_setzero_si256();
+    const __m128i index_step = _mm_set1_epi16(per_unit<vector_256, std::int32_t>);
+    __m128i index_base = _mm_setzero_si128();
+
+    for (std::size_t j(0); j < dim0; j += per_unit<vector_256, std::uint8_t>) {
+      const __m256i input_region_0 = _mm256_load_si256((__m256i*)(input + j + 0 * per_unit<vector_256, std::int16_t>));
+      const __m256i input_region_1 = _mm256_load_si256((__m256i*)(input + j + 1 * per_unit<vector_256, std::int16_t>));
+      const __m256i input_region = _mm256_permute4x64_epi64(_mm256_packus_epi16(input_region_0, input_region_1), 0b11011000);
+      _mm256_store_si256((__m256i*)(packed + j), input_region);
+
+      const int zero_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(input_region, zero)));
+      const int nonzero_mask = ~zero_mask & 0xFF;
+
+      const __m128i block_indices = _mm_load_si128((__m128i*)nonzero_block_indices.data[nonzero_mask]);
+      _mm_storeu_si128((__m128i*)(indices + count), _mm_add_epi16(index_base, block_indices));
+
+      count += static_cast<std::size_t>(__builtin_popcount(nonzero_mask));
+      index_base = _mm_add_epi16(index_base, index_step);
+    }
+  }
+};
+
+template <std::size_t dim0, std::size_t dim1>
+struct int16_sparse_crelu255_matrix_vector_product_x32_x8 {
+#if defined(__AVX512BW__)
+  using nonzero_blocks_type = int16_crelu255_nonzero_blocks_x64<dim0>;
+#else
+  using nonzero_blocks_type = int16_crelu255_nonzero_blocks_x32<dim0>;
+#endif
+
+  static constexpr std::size_t num_units = 8;
+  static constexpr std::size_t block_size = sparse_block_dim * num_units;
+  static constexpr bool available = dim1 == num_units && nonzero_blocks_type::available;
+
+  // as in the dense kernels, the pairs are formed with maddubs so that its int16 saturation is kept
+  static inline __m256i mm256_block_dot_add(const __m256i& sum, const std::int32_t& a, const std::int8_t* b) {
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+    return _mm256_dpwssd_epi32(sum, _mm256_maddubs_epi16(_mm256_set1_epi32(a), _mm256_load_si256((__m256i*)b)), _mm256_set1_epi16(1));
+#else
+    return _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_set1_epi16(1), _mm256_maddubs_epi16(_mm256_set1_epi32(a), _mm256_load_si256((__m256i*)b))));
+#endif
+  }
+
+  static inline std::size_t f(const std::int8_t* blocked_matrix, const std::int16_t* input, std::int32_t* output) noexcept {
+    const nonzero_blocks_type nonzero(input);
+    const std::int32_t* packed_blocks = (const std::int32_t*)nonzero.packed;
+
+    __m256i sum_0 = _mm256_setzero_si256();
+    __m256i sum_1 = _mm256_setzero_si256();
+    __m256i sum_2 = _mm256_setzero_si256();
+    __m256i sum_3 = _mm256_setzero_si256();
+
+    std::size_t i(0);
+    for (; i + 4 <= nonzero.count; i += 4) {
+      const std::size_t idx_0 = nonzero.indices[i + 0];
+      const std::size_t idx_1 = nonzero.indices[i + 1];
+      const std::size_t idx_2 = nonzero.indices[i + 2];
+      const std::size_t idx_3 = nonzero.indices[i + 3];
+      sum_0 = mm256_block_dot_add(sum_0, packed_blocks[idx_0], blocked_matrix + idx_0 * block_size);
+      sum_1 = mm256_block_dot_add(sum_1, packed_blocks[idx_1], blocked_matrix + idx_1 * block_size);
+      sum_2 = mm256_block_dot_add(sum_2, packed_blocks[idx_2], blocked_matrix + idx_2 * block_size);
+      sum_3 = mm256_block_dot_add(sum_3, packed_blocks[idx_3], blocked_matrix + idx_3 * block_size);
+    }
+
+    for (; i < nonzero.count; ++i) {
+      const std::size_t idx = nonzero.indices[i];
+      sum_0 = mm256_block_dot_add(sum_0, packed_blocks[idx], blocked_matrix + idx * block_size);
+    }
+
+    __m256i* v_output = (__m256i*)output;
+    *v_output = _mm256_add_epi32(*v_output, _mm256_add_epi32(_mm256_add_epi32(sum_0, sum_1), _mm256_add_epi32(sum_2, sum_3)));
+    return nonzero.count;
+  }
+};
+
+// matrix matrix forms of the float relu kernels. input and output are feature major blocks (row j holds
+// feature j of all block_dim inputs), so that eight inputs share each broadcast weight. every input keeps
+// the per lane partial sums and the reduction order of the matching matrix vector kernel, so results are
+// bit for bit those of evaluating the inputs one at a time.
+template <std::size_t dim0, std::size_t block_dim>
+struct float_relu_block_lanes_x8 {
+  static constexpr std::size_t num_lanes = per_unit<vector_256, float>;
+  static constexpr bool available = divides<dim0, num_lanes> && divides<block_dim, per_unit<vector_256, float>>;
+
+  static inline void f(const float* row, const float* input, const std::size_t& k, __m256* lanes) noexcept {
+    const __m256 zero = _mm256_setzero_ps();
+    for (std::size_t l(0); l < num_lanes; ++l) { lanes[l] = _mm256_setzero_ps(); }
+
+    for (std::size_t j(0); j < dim0; j += num_lanes) {
+      for (std::size_t l(0); l < num_lanes; ++l) {
+        const __m256 input_region = _mm256_max_ps(zero, _mm256_load_ps(input + (j + l) * block_dim + k));
+        lanes[l] = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(row[j + l]), input_region), lanes[l]);
+      }
+    }
+  }
+};
+
+template <std::size_t dim0, std::size_t dim1, std::size_t block_dim>
+struct float_relu_matrix_matrix_product_x8_x8 {
+  static constexpr bool available =
+      float_relu_matrix_vector_product_x8_x8<dim0, dim1>::available && float_relu_block_lanes_x8<dim0, block_dim>::available;
+
+  static inline void f(const float* matrix, const float* input, float* output) noexcept {
+    for (std::size_t i(0); i < dim1; ++i) {
+      for (std::size_t k(0); k < block_dim; k += per_unit<vector_256, float>) {
+        __m256 s[float_relu_block_lanes_x8<dim0, block_dim>::num_lanes];
+        float_relu_block_lanes_x8<dim0, block_dim>::f(matrix + i * dim0, input, k, s);
+
+        const __m256 sum = _mm256_add_ps(
+            _mm256_add_ps(_mm256_add_ps(s[0], s[1]), _mm256_add_ps(s[2], s[3])), _mm256_add_ps(_mm256_add_ps(s[4], s[5]), _mm256_add_ps(s[6], s[7])));
+        _mm256_store_ps(output + i * block_dim + k, _mm256_add_ps(_mm256_load_ps(output + i * block_dim + k), sum));
+      }
+    }
+  }
+};
+
+template <std::size_t dim0, std::size_t dim1, std::size_t block_dim>
+struct float_relu_matrix_matrix_product_x8_x1 {
+  static constexpr bool available = !float_relu_matrix_vector_product_x8_x8<dim0, dim1>::available &&
+                                    float_relu_matrix_vector_product_x8_x1<dim0, dim1>::available && float_relu_block_lanes_x8<dim0, block_dim>::available;
+
+  static inline void f(const float* matrix, const float* input, float* output) noexcept {
+    for (std::size_t i(0); i < dim1; ++i) {
+      for (std::size_t k(0); k < block_dim; k += per_unit<vector_256, float>) {
+        __m256 s[float_relu_block_lanes_x8<dim0, block_dim>::num_lanes];
+        float_relu_block_lanes_x8<dim0, block_dim>::f(matrix + i * dim0, input, k, s);
+
+        const __m256 sum = _mm256_add_ps(
+            _mm256_add_ps(_mm256_add_ps(s[0], s[4]), _mm256_add_ps(s[2], s[6])), _mm256_add_ps(_mm256_add_ps(s[1], s[5]), _mm256_add_ps(s[3], s[7])));
+        _mm256_store_ps(output + i * block_dim + k, _mm256_add_ps(_mm256_load_ps(output + i * block_dim + k), sum));
+      }
+    }
+  }
+};
+
+template <std::size_t dim0, std::size_t dim1>
+inline std::size_t sparse_crelu255_matrix_vector_product(const std::int8_t* blocked_matrix, const std::int16_t* input, std::int32_t* output) noexcept {
+  return overload_set<int16_sparse_crelu255_matrix_vector_product_x32_x8<dim0, dim1>>::f(blocked_matrix, input, output);
 }
 
 #elif defined(__SSSE3__)
@@ -546,12 +1240,145 @@ struct int16_relu_matrix_vector_product_x8_x8 {
   }
 };
 
+template <std::size_t dim0, std::size_t dim1>
+struct int16_crelu255_matrix_vector_product_x16_x8 {
+  static constexpr std::size_t num_units = 8;
+  static constexpr bool available = divides<dim1, num_units> && divides<dim0, per_unit<vector_128, std::int8_t>>;
+
+  static inline __m128i mm_maddubs_epi16_coalesced(const __m128i& a, const __m128i& b) {
+    return _mm_madd_epi16(_mm_set1_epi16(1), _mm_maddubs_epi16(a, b));
+  }
+
+  static inline void f(const std::int8_t* matrix, const std::int16_t* input, std::int32_t* output) noexcept {
+    __m128i* v_output = (__m128i*)output;
+    constexpr std::size_t output_step = num_units / per_unit<vector_128, std::int32_t>;
+    for (std::size_t i(0); i < dim1; i += num_units, v_output += output_step) {
+      __m128i sum_0 = _mm_setzero_si128();
+      __m128i sum_1 = _mm_setzero_si128();
+      __m128i sum_2 = _mm_setzero_si128();
+      __m128i sum_3 = _mm_setzero_si128();
+      __m128i sum_4 = _mm_setzero_si128();
+      __m128i sum_5 = _mm_setzero_si128();
+      __m128i sum_6 = _mm_setzero_si128();
+      __m128i sum_7 = _mm_setzero_si128();
+
+      for (std::size_t j(0); j < dim0; j += per_unit<vector_128, std::uint8_t>) {
+        const __m128i input_region_0 = _mm_load_si128((__m128i*)(input + j + 0 * per_unit<vector_128, std::int16_t>));
+        const __m128i input_region_1 = _mm_load_si128((__m128i*)(input + j + 1 * per_unit<vector_128, std::int16_t>));
+        const __m128i input_region = _mm_packus_epi16(input_region_0, input_region_1);
+
+        sum_0 = _mm_add_epi32(mm_maddubs_epi16_coalesced(input_region, _mm_load_si128((__m128i*)(matrix + (i + 0) * dim0 + j))), sum_0);
+        sum_1 = _mm_add_epi32(mm_maddubs_epi16_coalesced(input_region, _mm_load_si128((__m128i*)(matrix + (i + 1) * dim0 + j))), sum_1);
+        sum_2 = _mm_add_epi32(mm_maddubs_epi16_coalesced(input_region, _mm_load_si128((__m128i*)(matrix + (i + 2) * dim0 + j))), sum_2);
+        sum_3 = _mm_add_epi32(mm_maddubs_epi16_coalesced(input_region, _mm_load_si128((__m128i*)(matrix + (i + 3) * dim0 + j))), sum_3);
+        sum_4 = _mm_add_epi32(mm_maddubs_epi16_coalesced(input_region, _mm_load_si128((__m128i*)(matrix + (i + 4) * dim0 + j))), sum_4);
+        sum_5 = _mm_add_epi32(mm_maddubs_epi16_coalesced(input_region, _mm_load_si128((__m128i*)(matrix + (i + 5) * dim0 + j))), sum_5);
+        sum_6 = _mm_add_epi32(mm_maddubs_epi16_coalesced(input_region, _mm_load_si128((__m128i*)(matrix + (i + 6) * dim0 + j))), sum_6);
+        sum_7 = _mm_add_epi32(mm_maddubs_epi16_coalesced(input_region, _mm_load_si128((__m128i*)(matrix + (i + 7) * dim0 + j))), sum_7);
+      }
+
+      const __m128i sum_01 = _mm_hadd_epi32(sum_0, sum_1);
+      const __m128i sum_23 = _mm_hadd_epi32(sum_2, sum_3);
+      const __m128i sum_45 = _mm_hadd_epi32(sum_4, sum_5);
+      const __m128i sum_67 = _mm_hadd_epi32(sum_6, sum_7);
+
+      const __m128i sum_0123 = _mm_hadd_epi32(sum_01, sum_23);
+      const __m128i sum_4567 = _mm_hadd_epi32(sum_45, sum_67);
+
+      *(v_output + 0) = _mm_add_epi32(*(v_output + 0), sum_0123);
+      *(v_output + 1) = _mm_add_epi32(*(v_output + 1), sum_4567);
+    }
+  }
+};
+
+template <std::size_t dim0>
+struct int16_crelu255_nonzero_blocks_x16 {
+  static constexpr bool available = divides<dim0, 2 * per_unit<vector_128, std::uint8_t>>;
+  static constexpr std::size_t num_blocks = dim0 / sparse_block_dim;
+  static constexpr std::size_t index_slack = nonzero_block_index_table::mask_bits;
+
+  alignas(vector_128::size) std::uint8_t packed[dim0];
+  alignas(vector_128::size) std::uint16_t indices[num_blocks + index_slack];
+  std::size_t count;
+
+  inline explicit int16_crelu255_nonzero_blocks_x16(const std::int16_t* input) noexcept : count{0} {
+    static_assert(2 * per_unit<vector_128, std::int32_t> == nonzero_block_index_table::mask_bits);
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i index_step = _mm_set1_epi16(2 * per_unit<vector_128, std::int32_t>);
+    __m128i index_base = _mm_setzero_si128();
+
+    for (std::size_t j(0); j < dim0; j += 2 * per_unit<vector_128, std::uint8_t>) {
+      const __m128i input_region_0 = _mm_load_si128((__m128i*)(input + j + 0 * per_unit<vector_128, std::int16_t>));
+      const __m128i input_region_1 = _mm_load_si128((__m128i*)(input + j + 1 * per_unit<vector_128, std::int16_t>));
+      const __m128i input_region_2 = _mm_load_si128((__m128i*)(input + j + 2 * per_unit<vector_128, std::int16_t>));
+      const __m128i input_region_3 = _mm_load_si128((__m128i*)(input + j + 3 * per_unit<vector_128, std::int16_t>));
+
+      const __m128i input_region_01 = _mm_packus_epi16(input_region_0, input_region_1);
+      const __m128i input_region_23 = _mm_packus_epi16(input_region_2, input_region_3);
+      _mm_store_si128((__m128i*)(packed + j + 0 * per_unit<vector_128, std::uint8_t>), input_region_01);
+      _mm_store_si128((__m128i*)(packed + j + 1 * per_unit<vector_128, std::uint8_t>), input_region_23);
+
+      const int zero_mask_01 = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(input_region_01, zero)));
+      const int zero_mask_23 = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(input_region_23, zero)));
+      const int nonzero_mask = ~(zero_mask_01 | (zero_mask_23 << per_unit<vector_128, std::int32_t>)) & 0xFF;
+
+      const __m128i block_indices = _mm_load_si128((__m128i*)nonzero_block_indices.data[nonzero_mask]);
+      _mm_storeu_si128((__m128i*)(indices + count), _mm_add_epi16(index_base, block_indices));
+
+      count += static_cast<std::size_t>(__builtin_popcount(nonzero_mask));
+      index_base = _mm_add_epi16(index_base, index_step);
+    }
+  }
+};
+
+template <std::size_t dim0, std::size_t dim1>
+struct int16_sparse_crelu255_matrix_vector_product_x16_x8 {
+  static constexpr std::size_t num_units = 8;
+  static constexpr bool available = dim1 == num_units && int16_crelu255_nonzero_blocks_x16<dim0>::available;
+
+  static inline __m128i mm_block_dot(const __m128i& a, const __m128i& b) { return _mm_madd_epi16(_mm_set1_epi16(1), _mm_maddubs_epi16(a, b)); }
+
+  static inline std::size_t f(const std::int8_t* blocked_matrix, const std::int16_t* input, std::int32_t* output) noexcept {
+    const int16_crelu255_nonzero_blocks_x16<dim0> nonzero(input);
+    const std::int32_t* packed_blocks = (const std::int32_t*)nonzero.packed;
+    constexpr std::size_t block_size = sparse_block_dim * dim1;
+
+    __m128i sum_0 = _mm_setzero_si128();
+    __m128i sum_1 = _mm_setzero_si128();
+
+    for (std::size_t i(0); i < nonzero.count; ++i) {
+      const std::size_t idx = nonzero.indices[i];
+      const __m128i block_input = _mm_set1_epi32(packed_blocks[idx]);
+      const __m128i block_0 = _mm_load_si128((__m128i*)(blocked_matrix + idx * block_size + 0 * per_unit<vector_128, std::int8_t>));
+      const __m128i block_1 = _mm_load_si128((__m128i*)(blocked_matrix + idx * block_size + 1 * per_unit<vector_128, std::int8_t>));
+      sum_0 = _mm_add_epi32(mm_block_dot(block_input, block_0), sum_0);
+      sum_1 = _mm_add_epi32(mm_block_dot(block_input, block_1), sum_1);
+    }
+
+    __m128i* v_output = (__m128i*)output;
+    *(v_output + 0) = _mm_add_epi32(*(v_output + 0), sum_0);
+    *(v_output + 1) = _mm_add_epi32(*(v_output + 1), sum_1);
+    return nonzero.count;
+  }
+};
+
 template <std::size_t dim0, std::size_t dim1>
 inline void relu_matrix_vector_product(const float* matrix, const float* input, float* output) noexcept {
   return overload_set<float_relu_matrix_vector_product_x4_x8<dim0, dim1>, float_relu_matrix_vector_product_x8_x1<dim0, dim1>>::f(
       matrix, input, output);
 }
 
+template <std::size_t dim0, std::size_t dim1>
+inline std::size_t sparse_crelu255_matrix_vector_product(const std::int8_t* blocked_matrix, const std::int16_t* input, std::int32_t* output) noexcept {
+  return overload_set<int16_sparse_crelu255_matrix_vector_product_x16_x8<dim0, dim1>>::f(blocked_matrix, input, output);
+}
+
+template <std::size_t dim0, std::size_t dim1>
+inline void crelu255_matrix_vector_product(const std::int8_t* matrix, const std::int16_t* input, std::int32_t* output) noexcept {
+  return overload_set<int16_crelu255_matrix_vector_product_x16_x8<dim0, dim1>>::f(matrix, input, output);
+}
+
 template <std::size_t dim0, std::size_t dim1>
 inline void relu_matrix_vector_product(const std::int16_t* matrix, const std::int16_t* input, std::int32_t* output) noexcept {
   return overload_set<int16_relu_matrix_vector_product_x8_x8<dim0, dim1>>::f(matrix, input, output);
@@ -559,4 +1386,38 @@ inline void relu_matrix_vector_product(const std::int16_t* matrix, const std::in
 
 #endif
 
+// fallback for the matrix matrix product: each column of the feature major block goes through the matrix vector product
+template <std::size_t dim0, std::size_t dim1, std::size_t block_dim, typename T0, typename T1>
+struct relu_matrix_matrix_product_by_column {
+  static constexpr bool available = true;
+
+  static inline void f(const T0* matrix, const T0* input, T1* output) noexcept {
+    for (std::size_t k(0); k < block_dim; ++k) {
+      alignas(alignment) T0 column[dim0];
+      alignas(alignment) T1 result[dim1];
+      for (std::size_t j(0); j < dim0; ++j) { column[j] = input[j * block_dim + k]; }
+      for (std::size_t i(0); i < dim1; ++i) { result[i] = output[i * block_dim + k]; }
+
+      relu_matrix_vector_product<dim0, dim1>(matrix, column, result);
+      for (std::size_t i(0); i < dim1; ++i) { output[i * block_dim + k] = result[i]; }
+    }
+  }
+};
+
+template <std::size_t dim0, std::size_t dim1, std::size_t block_dim, typename T0, typename T1>
+inline void relu_matrix_matrix_product(const T0* matrix, const T0* input, T1* output) noexcept {
+#if defined(__AVX2__)
+  if constexpr (std::is_same_v<T0, float> && std::is_same_v<T1, float>) {
+    return overload_set<
+        float_relu_matrix_matrix_product_x8_x8<dim0, dim1, block_dim>,
+        float_relu_matrix_matrix_product_x8_x1<dim0, dim1, block_dim>,
+        relu_matrix_matrix_product_by_column<dim0, dim1, block_dim, T0, T1>>::f(matrix, input, output);
+  } else {
+    return relu_matrix_matrix_product_by_column<dim0, dim1, block_dim, T0, T1>::f(matrix, input, output);
+  }
+#else
+  return relu_matrix_matrix_product_by_column<dim0, dim1, block_dim, T0, T1>::f(matrix, input, output);
+#endif
+}
+
 }  // namespace simd
@@ -19,8 +19,12 @@
 
 #include <nnue/aligned_slice.h>
 #include <nnue/simd.h>
+#include <util/large_pages.h>
 
 #include <cstddef>
+#include <cstring>
+#include <memory>
+#include <utility>
 
 namespace nnue {
 
@@ -29,10 +33,70 @@ struct sparse_affine_layer {
   static constexpr std::size_t W_numel = dim0 * dim1;
   static constexpr std::size_t b_numel = dim1;
 
-  T* W{nullptr};
+  struct W_deleter {
+    util::large_pages::region large_page_region{};
+
+    void operator()(const T* ptr) const noexcept {
+      if (large_page_region.is_valid()) {
+        util::large_pages::deallocate(large_page_region);
+      } else {
+        simd::aligned_free(const_cast<T*>(ptr));
+      }
+    }
+  };
+
+  // W either owns an aligned allocation or is borrowed from a streamer (e.g. aliasing a
+  // memory mapped weights file), in which case rows are not guaranteed to be aligned. W is
+  // only written through the pointer returned by allocate_W_, and is null until the layer
+  // is loaded or assigned.
+  std::shared_ptr<const T> W_storage_{};
+  const T* W{nullptr};
   alignas(simd::alignment) T b[b_numel];
 
   [[nodiscard]] constexpr std::size_t num_parameters() const { return W_numel + b_numel; }
+  [[nodiscard]] bool owns_W() const noexcept { return std::get_deleter<W_deleter>(W_storage_) != nullptr; }
+
+  [[nodiscard]] util::large_pages::region W_large_page_region() const noexcept {
+    const W_deleter* deleter = std::get_deleter<W_deleter>(W_storage_);
+    return deleter != nullptr ? deleter->large_page_region : util::large_pages::region{};
+  }
+
+  [[nodiscard]] T* allocate_W_() noexcept {
+    T* owned_W = static_cast<T*>(simd::aligned_alloc(simd::alignment, sizeof(T) * W_numel));
+    W_storage_ = std::shared_ptr<const T>(owned_W, W_deleter{});
+    W = owned_W;
+    return owned_W;
+  }
+
+  // W when it is owned (and hence writable) by this layer, and a newly allocated W otherwise
+  [[nodiscard]] T* owned_W_() noexcept { return owns_W() ? const_cast<T*>(W) : allocate_W_(); }
+
+  // moves W into memory backed by huge pages where available. incremental updates gather
+  // random rows of W, so this mostly serves to reduce dTLB misses. W is left untouched if
+  // no such memory can be obtained.
+  [[maybe_unused]] util::large_pages::region use_large_pages() noexcept {
+    if (W == nullptr) { return util::large_pages::region{}; }
+    if (W_large_page_region().is_valid()) { return W_large_page_region(); }
+
+    const util::large_pages::region large_page_region = util::large_pages::allocate(sizeof(T) * W_numel);
+    if (!large_page_region.is_valid()) { return large_page_region; }
+
+    T* large_page_W = static_cast<T*>(large_page_region.data);
+    std::memcpy(large_page_W, W, sizeof(T) * W_numel);
+
+    W_storage_ = std::shared_ptr<const T>(large_page_W, W_deleter{large_page_region});
+    W = large_page_W;
+    return large_page_region;
+  }
+
+  [[maybe_unused]] void use_small_pages() noexcept {
+    if (!W_large_page_region().is_valid()) { return; }
+
+    const T* previous_W = W;
+    std::shared_ptr<const T> previous_W_storage = std::move(W_storage_);
+
+    std::memcpy(allocate_W_(), previous_W, sizeof(T) * W_numel);
+  }
 
   void insert_idx(const std::size_t idx, aligned_slice<T, b_numel> x) const {
     const T* mem_region = W + idx * dim1;
@@ -66,9 +130,28 @@ struct sparse_affine_layer {
     simd::add_add_sub_sub<b_numel>(src.data, insert_mem_region, erase_mem_region_0, erase_mem_region_1, dst.data);
   }
 
+  void insert_erase_many_idx(
+      const std::size_t* insert_idx,
+      const std::size_t& num_insert,
+      const std::size_t* erase_idx,
+      const std::size_t& num_erase,
+      const T* src,
+      aligned_slice<T, b_numel> dst) const {
+    simd::add_sub_rows<b_numel>(W, src, insert_idx, num_insert, erase_idx, num_erase, dst.data);
+  }
+
   template <typename streamer_type>
   sparse_affine_layer<T, dim0, dim1>& load_(streamer_type& streamer) noexcept {
-    streamer.template stream<T>(W, W_numel).template stream<T>(b, b_numel);
+    if constexpr (streamer_type::borrows_storage) {
+      if (std::shared_ptr<const T> borrowed = streamer.template borrow<T>(W_numel)) {
+        W_storage_ = std::move(borrowed);
+        W = W_storage_.get();
+        streamer.template stream<T>(b, b_numel);
+        return *this;
+      }
+    }
+
+    streamer.template stream<T>(owned_W_(), W_numel).template stream<T>(b, b_numel);
     return *this;
   }
 
@@ -82,41 +165,46 @@ struct sparse_affine_layer {
   sparse_affine_layer<U, dim0, dim1> quantized(const T& scale) const {
     static_assert(std::is_floating_point_v<T> && std::is_integral_v<U>);
     sparse_affine_layer<U, dim0, dim1> result{};
+    U* result_W = result.allocate_W_();
 #pragma omp simd
-    for (std::size_t i = 0; i < W_numel; ++i) { result.W[i] = static_cast<U>(std::round(scale * W[i])); }
+    for (std::size_t i = 0; i < W_numel; ++i) { result_W[i] = static_cast<U>(std::round(scale * W[i])); }
     for (std::size_t i = 0; i < b_numel; ++i) { result.b[i] = static_cast<U>(std::round(scale * b[i])); }
     return result;
   }
 
   sparse_affine_layer<T, dim0, dim1>& operator=(const sparse_affine_layer<T, dim0, dim1>& other) {
-#pragma omp simd
-    for (std::size_t i = 0; i < W_numel; ++i) { W[i] = other.W[i]; }
+    if (this == &other) { return *this; }
+
+    if (other.W != nullptr) {
+      std::memcpy(owned_W_(), other.W, sizeof(T) * W_numel);
+    } else {
+      W_storage_.reset();
+      W = nullptr;
+    }
+
     for (std::size_t i = 0; i < b_numel; ++i) { b[i] = other.b[i]; }
     return *this;
   }
 
   sparse_affine_layer<T, dim0, dim1>& operator=(sparse_affine_layer<T, dim0, dim1>&& other) noexcept {
+    std::swap(W_storage_, other.W_storage_);
     std::swap(W, other.W);
     std::swap(b, other.b);
     return *this;
   }
 
   sparse_affine_layer(const sparse_affine_layer<T, dim0, dim1>& other) {
-    W = static_cast<T*>(simd::aligned_alloc(simd::alignment, sizeof(T) * W_numel));
-#pragma omp simd
-    for (std::size_t i = 0; i < W_numel; ++i) { W[i] = other.W[i]; }
+    if (other.W != nullptr) { std::memcpy(allocate_W_(), other.W, sizeof(T) * W_numel); }
     for (std::size_t i = 0; i < b_numel; ++i) { b[i] = other.b[i]; }
   }
 
   sparse_affine_layer(sparse_affine_layer<T, dim0, dim1>&& other) noexcept {
+    std::swap(W_storage_, other.W_storage_);
     std::swap(W, other.W);
     std::swap(b, other.b);
   }
 
-  sparse_affine_layer() { W = static_cast<T*>(simd::aligned_alloc(simd::alignment, sizeof(T) * W_numel)); }
-  ~sparse_affine_layer() {
-    if (W != nullptr) { simd::aligned_free(W); }
-  }
+  sparse_affine_layer() = default;
 };
 
 }  // namespace nnue
@@ -19,6 +19,7 @@
 #include <chess/board.h>
 #include <chess/types.h>
 #include <feature/util.h>
+#include <nnue/column_blocked_affine_layer.h>
 #include <nnue/dense_relu_affine_layer.h>
 #include <nnue/sparse_affine_layer.h>
 #include <nnue/weights_exporter.h>
@@ -112,6 +113,10 @@ struct quantized_weights {
   dense_relu_affine_layer<2 * base_dim, 8, half_quantized_parameter_type, quantized_parameter_type> white_fc0{};
   dense_relu_affine_layer<2 * base_dim, 8, half_quantized_parameter_type, quantized_parameter_type> black_fc0{};
 
+  column_blocked_affine_layer<2 * base_dim, 8, half_quantized_parameter_type, quantized_parameter_type> white_blocked_fc0{};
+  column_blocked_affine_layer<2 * base_dim, 8, half_quantized_parameter_type, quantized_parameter_type> black_blocked_fc0{};
+  bool sparse_fc0{false};
+
   dense_relu_affine_layer<8, 8, parameter_type> fc1{};
   dense_relu_affine_layer<16, 8, parameter_type> fc2{};
   dense_relu_affine_layer<24, 1, parameter_type> fc3{};
@@ -122,6 +127,17 @@ struct quantized_weights {
     return shared.num_parameters() + fc0.num_parameters() + fc1.num_parameters() + fc2.num_parameters() + fc3.num_parameters();
   }
 
+  void update_blocked_fc0_() noexcept {
+    white_blocked_fc0 = decltype(white_blocked_fc0)::from(white_fc0);
+    black_blocked_fc0 = decltype(black_blocked_fc0)::from(black_fc0);
+  }
+
+  // the column blocked copies are only built while the sparse path is in use
+  void set_sparse_fc0(const bool& value) noexcept {
+    if (value && !sparse_fc0) { update_blocked_fc0_(); }
+    sparse_fc0 = value;
+  }
+
   template <typename streamer_type>
   [[maybe_unused]] quantized_weights& load(streamer_type& streamer) noexcept {
     streamer.stream(&signature_);
@@ -135,6 +151,7 @@ struct quantized_weights {
     white_fc0 = fc0;
     black_fc0 = white_fc0.half_input_flipped();
 
+    if (sparse_fc0) { update_blocked_fc0_(); }
     return *this;
   }
 
@@ -152,6 +169,9 @@ struct quantized_weights {
   }
 
   [[maybe_unused]] quantized_weights& load(const std::string& path) noexcept {
+    auto mapped_streamer = mapped_weights_streamer(path);
+    if (mapped_streamer.is_open()) { return load(mapped_streamer); }
+
     auto streamer = weights_streamer(path);
     return load(streamer);
   }
@@ -17,17 +17,42 @@
 
 #pragma once
 
+#include <nnue/mapped_file.h>
+
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <istream>
+#include <memory>
 #include <streambuf>
+#include <string>
+#include <type_traits>
 
 namespace nnue {
 
+// equivalent to folding the leading (at most four) bytes of each of request elements of
+// type T into the signature one at a time, but written as a single reduction so that it
+// vectorizes.
+template <typename T>
+[[nodiscard]] inline std::uint32_t xor_signature(const unsigned char* data, const std::size_t request) noexcept {
+  using word_type = std::conditional_t<sizeof(T) == 1, std::uint8_t, std::conditional_t<sizeof(T) == 2, std::uint16_t, std::uint32_t>>;
+  word_type signature{0};
+
+#pragma omp simd reduction(^ : signature)
+  for (std::size_t i = 0; i < request; ++i) {
+    word_type x{};
+    std::memcpy(&x, data + i * sizeof(T), sizeof(word_type));
+    signature ^= x;
+  }
+
+  return static_cast<std::uint32_t>(signature);
+}
+
 struct weights_streamer {
   using signature_type = std::uint32_t;
+  static constexpr bool borrows_storage = false;
 
   signature_type signature_{0};
   std::fstream reader;
@@ -57,31 +82,77 @@ struct weights_streamer {
 struct embedded_weight_streamer {
   static_assert(1 == sizeof(unsigned char), "unsigned char must be one byte wide");
   using signature_type = std::uint32_t;
+  static constexpr bool borrows_storage = true;
 
   signature_type signature_{0};
   const unsigned char* back_ptr;
 
   template <typename T>
   [[maybe_unused]] embedded_weight_streamer& stream(T* dst, const std::size_t request = static_cast<std::size_t>(1)) noexcept {
-    constexpr std::size_t signature_bytes = std::min(sizeof(signature_type), sizeof(T));
-    std::array<unsigned char, sizeof(T)> single_element{};
+    std::memcpy(dst, back_ptr, request * sizeof(T));
+    signature_ ^= xor_signature<T>(back_ptr, request);
+    back_ptr += request * sizeof(T);
+    return *this;
+  }
 
-    for (std::size_t i(0); i < request; ++i) {
-      std::memcpy(single_element.data(), back_ptr, single_element.size());
-      back_ptr += single_element.size();
-      std::memcpy(dst + i, single_element.data(), single_element.size());
+  // the embedded weights live in the read only data of the executable and are shared
+  // between processes. borrowed tensors have no owner.
+  template <typename T>
+  [[nodiscard]] std::shared_ptr<const T> borrow(const std::size_t request) noexcept {
+    const bool aligned = (reinterpret_cast<std::uintptr_t>(back_ptr) % alignof(T)) == 0;
+    if (!aligned) { return nullptr; }
+
+    const T* src = reinterpret_cast<const T*>(back_ptr);
+    signature_ ^= xor_signature<T>(back_ptr, request);
+    back_ptr += request * sizeof(T);
+    return std::shared_ptr<const T>(std::shared_ptr<const T>{}, src);
+  }
 
-      signature_type x{};
-      std::memcpy(&x, single_element.data(), signature_bytes);
-      signature_ ^= x;
-    }
+  [[nodiscard]] constexpr const signature_type& signature() const noexcept { return signature_; }
 
+  explicit embedded_weight_streamer(const unsigned char* data) noexcept : back_ptr{data} {}
+};
+
+// reads weights from a memory mapped file. large tensors may be borrowed rather than
+// copied: the returned pointer aliases the mapping and keeps it alive.
+struct mapped_weights_streamer {
+  using signature_type = std::uint32_t;
+  static constexpr bool borrows_storage = true;
+
+  signature_type signature_{0};
+  std::shared_ptr<mapped_file> file_;
+  std::size_t offset_{0};
+
+  [[nodiscard]] bool is_open() const noexcept { return file_->is_open(); }
+  [[nodiscard]] std::size_t remaining() const noexcept { return file_->size() - offset_; }
+
+  template <typename T>
+  [[maybe_unused]] mapped_weights_streamer& stream(T* dst, const std::size_t request = static_cast<std::size_t>(1)) noexcept {
+    const std::size_t available = std::min(request, remaining() / sizeof(T));
+    const unsigned char* src = file_->data() + offset_;
+
+    std::memcpy(dst, src, available * sizeof(T));
+    std::fill(dst + available, dst + request, T{});
+
+    signature_ ^= xor_signature<T>(src, available);
+    offset_ += available * sizeof(T);
     return *this;
   }
 
+  template <typename T>
+  [[nodiscard]] std::shared_ptr<const T> borrow(const std::size_t request) noexcept {
+    const unsigned char* src = file_->data() + offset_;
+    const bool aligned = (reinterpret_cast<std::uintptr_t>(src) % alignof(T)) == 0;
+    if (!aligned || request > remaining() / sizeof(T)) { return nullptr; }
+
+    signature_ ^= xor_signature<T>(src, request);
+    offset_ += request * sizeof(T);
+    return std::shared_ptr<const T>(file_, reinterpret_cast<const T*>(src));
+  }
+
   [[nodiscard]] constexpr const signature_type& signature() const noexcept { return signature_; }
 
-  explicit embedded_weight_streamer(const unsigned char* data) noexcept : back_ptr{data} {}
+  explicit mapped_weights_streamer(const std::string& name) noexcept : file_{std::make_shared<mapped_file>(name)} {}
 };
 
 }  // namespace nnue
@@ -63,6 +63,12 @@ inline constexpr score_type draw_score = 0;
 
 inline constexpr score_type aspiration_delta = 21;
 
+[[nodiscard]] constexpr score_type to_centipawns(const score_type& score) noexcept {
+  constexpr score_type raw_multiplier = 288;
+  constexpr score_type raw_divisor = 1024;
+  return score * raw_multiplier / raw_divisor;
+}
+
 using counter_type = std::int32_t;
 
 using see_type = std::int32_t;
@@ -73,9 +79,11 @@ struct fixed_search_constants final {
   static constexpr bool tuning = false;
   static constexpr depth_type lmr_tbl_dim = 64;
   std::size_t thread_count_;
+  std::size_t multi_pv_{1};
   std::array<depth_type, lmr_tbl_dim * lmr_tbl_dim> lmr_tbl{};
 
   [[nodiscard]] const std::size_t& thread_count() const noexcept { return thread_count_; }
+  [[nodiscard]] const std::size_t& multi_pv() const noexcept { return multi_pv_; }
 
   [[nodiscard]] constexpr depth_type reduce_depth() const noexcept { return 2; }
   [[nodiscard]] constexpr depth_type aspiration_depth() const noexcept { return 4; }
@@ -164,6 +172,11 @@ struct fixed_search_constants final {
     return *this;
   }
 
+  [[maybe_unused]] fixed_search_constants& update_multi_pv_(const std::size_t& multi_pv) noexcept {
+    multi_pv_ = multi_pv;
+    return *this;
+  }
+
   explicit fixed_search_constants(const std::size_t& thread_count = 1) noexcept { update_(thread_count); }
 };
 
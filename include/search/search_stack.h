@@ -59,6 +59,7 @@ struct search_stack {
     return *this;
   }
 
+  [[nodiscard]] std::string pv_string(const std::array<chess::move, safe_depth>& pv) const noexcept;
   [[nodiscard]] std::string pv_string() const noexcept;
   [[nodiscard]] chess::move ponder_move() const noexcept;
 
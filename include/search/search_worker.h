@@ -26,6 +26,7 @@
 #include <search/search_worker_external_state.h>
 #include <search/search_worker_internal_state.h>
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 
@@ -98,15 +99,29 @@ struct search_worker {
   [[nodiscard]] chess::move ponder_move() const noexcept { return chess::move{internal.ponder_move.load()}; }
   [[nodiscard]] score_type score() const noexcept { return internal.score.load(); }
 
-  void go(const chess::board_history& hist, const chess::board& bd, const depth_type& start_depth) noexcept {
+  void go(const chess::board_history& hist, const chess::board& bd, const depth_type& start_depth, const chess::move_list& root_moves = {}) noexcept {
+    const chess::move_list legal_moves = bd.generate_moves<>();
+
+    // restrictions to moves which aren't legal are ignored. if none of the moves are legal, the search is unrestricted
+    internal.root_moves = chess::move_list{};
+    for (const auto& mv : root_moves) {
+      if (legal_moves.has(mv) && !internal.root_moves.has(mv)) { internal.root_moves.push(mv); }
+    }
+
+    const chess::move_list& candidate_moves = internal.root_moves.empty() ? legal_moves : internal.root_moves;
+
     internal.go.store(true);
     internal.node_distribution.clear();
     internal.nodes.store(0);
     internal.tb_hits.store(0);
     internal.depth.store(start_depth);
-    internal.best_move.store(bd.generate_moves<>().begin()->data);
+    internal.best_move.store(candidate_moves.begin()->data);
     internal.ponder_move.store(chess::move::null().data);
     internal.stack = search_stack(hist, bd);
+
+    const std::size_t num_moves = candidate_moves.size();
+    internal.lines.assign(std::max<std::size_t>(1, std::min(external.constants->multi_pv(), num_moves)), pv_line{});
+    internal.line_idx = 0;
   }
 
   void stop() noexcept { internal.go.store(false); }
@@ -18,17 +18,28 @@
 #pragma once
 
 #include <chess/move.h>
+#include <chess/move_list.h>
 #include <nnue/eval.h>
 #include <nnue/feature_reset_cache.h>
 #include <search/eval_correction_history.h>
 #include <search/history_heuristic.h>
 #include <search/search_stack.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <unordered_map>
+#include <vector>
 
 namespace search {
 
+struct pv_line {
+  score_type score{};
+  std::array<chess::move, safe_depth> pv{};
+
+  [[nodiscard]] constexpr chess::move move() const noexcept { return pv.front(); }
+};
+
 struct search_worker_internal_state {
   nnue::sided_feature_reset_cache reset_cache{};
   search_stack stack{chess::board_history{}, chess::board::start_pos()};
@@ -37,6 +48,14 @@ struct search_worker_internal_state {
   sided_eval_correction_history correction{};
   std::unordered_map<chess::move, std::size_t, chess::move_hash> node_distribution{};
 
+  // when non-empty, only these moves are searched at the root ("go searchmoves").
+  chess::move_list root_moves{};
+
+  // lines [0, line_idx) have already been searched in the current iteration and their first moves
+  // are skipped at the root when searching line line_idx.
+  std::vector<pv_line> lines{};
+  std::size_t line_idx{};
+
   std::atomic_bool go{false};
   std::atomic_size_t nodes{};
   std::atomic_size_t tb_hits{};
@@ -49,6 +68,16 @@ struct search_worker_internal_state {
 
   [[nodiscard]] bool keep_going() const noexcept { return go.load(std::memory_order::memory_order_relaxed); }
 
+  [[nodiscard]] bool is_searched_line(const chess::move& mv) const noexcept {
+    return std::any_of(lines.begin(), lines.begin() + line_idx, [&mv](const pv_line& line) { return line.move() == mv; });
+  }
+
+  [[nodiscard]] bool is_skipped_root_move(const chess::move& mv) const noexcept {
+    return (!root_moves.empty() && !root_moves.has(mv)) || is_searched_line(mv);
+  }
+
+  [[nodiscard]] bool has_skipped_root_moves() const noexcept { return !root_moves.empty() || line_idx != 0; }
+
   template <std::size_t N>
   [[nodiscard]] inline bool one_of() const noexcept {
     static_assert((N != 0) && ((N & (N - 1)) == 0), "N must be a power of 2");
@@ -61,6 +90,9 @@ struct search_worker_internal_state {
     hh.clear();
     correction.clear();
     node_distribution.clear();
+    root_moves = chess::move_list{};
+    lines.clear();
+    line_idx = 0;
 
     go.store(false);
     nodes.store(0);
@@ -42,9 +42,17 @@ struct worker_orchestrator {
   void reset() noexcept;
   void resize(const std::size_t& new_size) noexcept;
 
-  void go(const chess::board_history& hist, const chess::board& bd) noexcept;
+  // runs fn(0), ..., fn(count - 1) with call i on worker thread i, calls past the last worker running on
+  // the calling thread. used to clear and first touch the transposition table from the search threads.
+  void parallel_for(const std::size_t& count, const std::function<void(const std::size_t&)>& fn) noexcept;
+
+  void go(const chess::board_history& hist, const chess::board& bd, const chess::move_list& root_moves = {}) noexcept;
   void stop() noexcept;
 
+  // blocks until every worker thread has left its search. a worker's search only ends once it is
+  // stopped, so some other thread (typically the primary worker's on_iter callback) must call stop.
+  void wait() noexcept;
+
   [[nodiscard]] bool is_searching() noexcept;
 
   [[nodiscard]] std::size_t nodes() const noexcept;
@@ -57,6 +65,8 @@ struct worker_orchestrator {
       const std::size_t hash_table_size,
       std::function<void(const search_worker&)> on_iter = [](auto&&...) {},
       std::function<void(const search_worker&)> on_update = [](auto&&...) {}) noexcept;
+
+  ~worker_orchestrator() noexcept;
 };
 
 }  // namespace search
@@ -16,16 +16,18 @@
 */
 
 #include <chess/move.h>
+#include <chess/move_list.h>
 #include <search/search_worker.h>
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <thread>
 
 namespace search {
 
-enum class thread_state { initializing, pending, searching, exiting };
+enum class thread_state { initializing, pending, searching, tasked, exiting };
 
 struct search_worker_thread {
   search_worker_external_state external_state_;
@@ -39,6 +41,7 @@ struct search_worker_thread {
 
   std::unique_ptr<search_worker> worker_{nullptr};
   std::unique_ptr<std::thread> worker_thread_{nullptr};
+  std::function<void()> task_{};
 
   search_worker_thread(const search_worker_external_state& external_state) noexcept : external_state_{external_state} {
     worker_thread_ = std::make_unique<std::thread>([this] { thread_loop_(); });
@@ -52,9 +55,9 @@ struct search_worker_thread {
   [[nodiscard]] search_worker& worker() noexcept { return *worker_; }
   [[nodiscard]] const search_worker& worker() const noexcept { return *worker_; }
 
-  void go(const chess::board_history& hist, const chess::board& bd, const depth_type& start_depth) noexcept {
+  void go(const chess::board_history& hist, const chess::board& bd, const depth_type& start_depth, const chess::move_list& root_moves) noexcept {
     stop_sync_();
-    worker_->go(hist, bd, start_depth);
+    worker_->go(hist, bd, start_depth, root_moves);
 
     {
       std::unique_lock lock(caller_to_thread_mutex_);
@@ -63,17 +66,30 @@ struct search_worker_thread {
     }
   }
 
+  // runs task on this worker's thread in place of a search. wait blocks until the task has finished
+  void run(std::function<void()> task) noexcept {
+    stop_sync_();
+    task_ = std::move(task);
+
+    {
+      std::unique_lock lock(caller_to_thread_mutex_);
+      thread_state_ = thread_state::tasked;
+      caller_to_thread_cv_.notify_one();
+    }
+  }
+
   void stop() noexcept { stop_nosync_(); }
 
   void stop_nosync_() noexcept { worker_->stop(); }
 
   void stop_sync_() noexcept {
     worker_->stop();
+    wait();
+  }
 
-    {
-      std::unique_lock lock(thread_to_caller_mutex_);
-      thread_to_caller_cv_.wait(lock, [this] { return thread_state_ == thread_state::pending; });
-    }
+  void wait() noexcept {
+    std::unique_lock lock(thread_to_caller_mutex_);
+    thread_to_caller_cv_.wait(lock, [this] { return thread_state_ == thread_state::pending; });
   }
 
   void thread_loop_() noexcept {
@@ -93,6 +109,11 @@ struct search_worker_thread {
       if (thread_state_ == thread_state::exiting) { break; }
       if (thread_state_ == thread_state::searching) { worker_->iterative_deepening_loop(); }
 
+      if (thread_state_ == thread_state::tasked) {
+        task_();
+        task_ = nullptr;
+      }
+
       {
         std::unique_lock lock(thread_to_caller_mutex_);
         thread_state_ = thread_state::pending;
@@ -20,18 +20,22 @@
 #include <chess/move.h>
 #include <search/search_constants.h>
 #include <util/bit_range.h>
+#include <util/large_pages.h>
+#include <util/shared_memory.h>
 #include <zobrist/util.h>
 
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <optional>
+#include <string>
 #include <string_view>
-#include <vector>
 
 namespace search {
 
@@ -62,12 +66,18 @@ struct transposition_table_entry {
   using tt_pv_ = util::next_bit_flag<gen_>;
   using was_exact_or_lb_ = util::next_bit_flag<tt_pv_>;
 
+  // key_ is stored xored with a checksum of the eval and search words, so that an entry torn by
+  // concurrent writes (its words taken from different stores) no longer matches its key.
   zobrist::half_hash_type key_{empty_key};
   zobrist::half_hash_type eval_{};
   zobrist::hash_type search_{};
 
-  [[nodiscard]] constexpr bool key_matches(const zobrist::hash_type& other_key) const noexcept { return key_ == zobrist::upper_half(other_key); }
-  [[nodiscard]] constexpr zobrist::half_hash_type key() const noexcept { return key_; }
+  [[nodiscard]] constexpr zobrist::half_hash_type checksum_() const noexcept {
+    return eval_ ^ zobrist::lower_half(search_) ^ zobrist::upper_half(search_);
+  }
+
+  [[nodiscard]] constexpr bool key_matches(const zobrist::hash_type& other_key) const noexcept { return key() == zobrist::upper_half(other_key); }
+  [[nodiscard]] constexpr zobrist::half_hash_type key() const noexcept { return key_ ^ checksum_(); }
 
   // eval
   [[nodiscard]] constexpr zobrist::quarter_hash_type eval_feature_hash() const noexcept { return eval_feature_hash_::get(eval_); }
@@ -90,18 +100,22 @@ struct transposition_table_entry {
   [[nodiscard]] constexpr bool was_exact_or_lb() const noexcept { return was_exact_or_lb_::get(search_); }
   [[nodiscard]] constexpr bool tt_pv() const noexcept { return tt_pv_::get(search_); }
 
-  [[nodiscard]] constexpr bool is_empty() const noexcept { return key_ == empty_key; }
+  [[nodiscard]] constexpr bool is_empty() const noexcept { return key() == empty_key; }
   [[nodiscard]] constexpr bool is_current(const gen_type& gen) const noexcept { return gen == gen_::get(search_); }
 
   [[maybe_unused]] constexpr transposition_table_entry& set_gen(const gen_type& gen) noexcept {
+    const zobrist::half_hash_type current_key = key();
     gen_::set(search_, gen);
+    key_ = current_key ^ checksum_();
     return *this;
   }
 
   [[maybe_unused]] constexpr transposition_table_entry& merge(const transposition_table_entry& other) noexcept {
     if (bound() == bound_type::upper && other.was_exact_or_lb() && key() == other.key()) {
+      const zobrist::half_hash_type current_key = key();
       best_move_::set(search_, other.best_move().data);
       was_exact_or_lb_::set(search_, true);
+      key_ = current_key ^ checksum_();
     }
 
     return *this;
@@ -131,12 +145,16 @@ struct transposition_table_entry {
 
     tt_pv_::set(search_, tt_pv);
     was_exact_or_lb_::set(search_, bound != bound_type::upper);
+
+    key_ ^= checksum_();
   }
 
   constexpr transposition_table_entry(const zobrist::hash_type& key, const eval_data_packet& packet) noexcept : key_{zobrist::upper_half(key)} {
     eval_feature_hash_::set(eval_, packet.eval_feature_hash);
     eval_before_adjustment_::set(eval_, static_cast<eval_before_adjustment_::type>(packet.eval_before_adjustment));
     search_present_::set(search_, false);
+
+    key_ ^= checksum_();
   }
 
   constexpr transposition_table_entry() noexcept = default;
@@ -153,8 +171,13 @@ struct alignas(cache_line_size) bucket {
   [[nodiscard]] constexpr std::optional<transposition_table_entry> match(
       const transposition_table_entry::gen_type& gen,
       const zobrist::hash_type& key) noexcept {
+    // entries are verified on a private copy, as the shared entry may be rewritten while it is read
     for (auto& elem : data) {
-      if (elem.key_matches(key)) { return std::optional(elem.set_gen(gen)); }
+      transposition_table_entry entry = elem;
+      if (!entry.key_matches(key)) { continue; }
+
+      if (!entry.is_current(gen)) { elem = entry.set_gen(gen); }
+      return std::optional(entry);
     }
 
     return std::nullopt;
@@ -177,23 +200,111 @@ struct alignas(cache_line_size) bucket {
   }
 };
 
+struct transposition_table_stats {
+  std::size_t sampled{0};
+  std::size_t occupied{0};
+  std::size_t current{0};
+  std::size_t search_present{0};
+  std::size_t eval_only{0};
+  std::array<std::size_t, 3> bounds{};
+  std::array<std::size_t, max_depth + 1> depths{};
+
+  // occupancy in per mille of the sampled entries, counting only those of the current generation
+  [[nodiscard]] std::size_t hashfull() const noexcept {
+    constexpr std::size_t per_mille = 1000;
+    return sampled == 0 ? 0 : per_mille * current / sampled;
+  }
+};
+
+[[maybe_unused]] std::ostream& operator<<(std::ostream& os, const transposition_table_stats& stats) noexcept;
+
+// header preceding the raw buckets in a saved table. it is padded to a cache line so that the
+// buckets of a mapped file keep their alignment.
+struct alignas(cache_line_size) transposition_table_file_header {
+  static constexpr std::uint64_t expected_magic = 0x6873616872656573;
+  static constexpr std::uint32_t expected_layout_version = 1;
+
+  std::uint64_t magic{expected_magic};
+  std::uint32_t layout_version{expected_layout_version};
+  std::uint32_t entry_size{0};
+  std::uint32_t per_bucket{0};
+  std::uint32_t signature{0};
+  std::uint64_t size{0};
+  std::uint64_t current_gen{0};
+};
+
+enum class transposition_table_file_status { ok, unreadable, bad_header, layout_mismatch, signature_mismatch, size_mismatch };
+
+[[nodiscard]] std::string_view to_string(const transposition_table_file_status& status) noexcept;
+
 struct transposition_table {
   static constexpr std::size_t per_bucket = cache_line_size / sizeof(transposition_table_entry);
   static constexpr std::size_t one_mb = (1 << 20) / cache_line_size;
+  static constexpr std::size_t hashfull_sample_buckets = 1000 / per_bucket;
+  static constexpr std::size_t stats_sample_buckets = one_mb;
 
   using bucket_type = bucket<per_bucket>;
 
   static_assert(cache_line_size % sizeof(transposition_table_entry) == 0, "transposition_table_entry must divide cache_line_size");
   static_assert(sizeof(bucket_type) == cache_line_size && alignof(bucket_type) == cache_line_size, "bucket_type must be cache_line_size aligned");
 
-  std::atomic<transposition_table_entry::gen_type> current_gen{0};
-  std::vector<bucket_type> data;
-
-  [[nodiscard]] inline std::size_t hash_function(const zobrist::hash_type& hash) const noexcept { return hash % data.size(); }
-  inline void prefetch(const zobrist::hash_type& key) const noexcept { __builtin_prefetch(data.data() + hash_function(key)); }
-
-  void clear() noexcept;
-  void resize(const std::size_t& size) noexcept;
+  using gen_type = transposition_table_entry::gen_type;
+  static_assert(std::atomic<gen_type>::is_always_lock_free, "gen_type must be lock free to be shared between processes");
+
+  // the generation of a shared table lives in the first cache line of the shared payload, so that
+  // every attached process ages the same table
+  std::atomic<gen_type> local_gen_{0};
+  std::atomic<gen_type>* current_gen_{&local_gen_};
+
+  // buckets live in an anonymous mapping which is left untouched until clear, so that each page is
+  // first touched (and hence placed) by whichever clearing thread owns it. region_ is valid whenever
+  // the buckets are mapped rather than allocated with new[].
+  bucket_type* data_{nullptr};
+  std::size_t size_{0};
+  bool use_large_pages_{false};
+  util::large_pages::region region_{};
+  std::string shared_name_{};
+  util::shared_memory::segment shared_{};
+
+  [[nodiscard]] inline std::size_t size() const noexcept { return size_; }
+  [[nodiscard]] inline bool is_shared() const noexcept { return shared_.is_valid(); }
+  [[nodiscard]] inline std::atomic<gen_type>& current_gen() noexcept { return *current_gen_; }
+  [[nodiscard]] inline const std::atomic<gen_type>& current_gen() const noexcept { return *current_gen_; }
+  [[nodiscard]] inline std::size_t hash_function(const zobrist::hash_type& hash) const noexcept { return hash % size_; }
+  inline void prefetch(const zobrist::hash_type& key) const noexcept { __builtin_prefetch(data_ + hash_function(key)); }
+
+  void allocate_(const std::size_t& size) noexcept;
+  void deallocate_() noexcept;
+
+  // runs fn(0), ..., fn(count - 1) concurrently and returns once every call has finished. when unset, each
+  // call gets a thread of its own. the worker orchestrator routes the calls onto its search threads
+  // instead, so that the pages of each slice are first touched by a thread which later probes them.
+  using parallel_for_type = std::function<void(const std::size_t&, const std::function<void(const std::size_t&)>&)>;
+  parallel_for_type parallel_for_{};
+
+  // splits the buckets into thread_count contiguous slices and calls fn(begin, end) for each slice through parallel_for_
+  template <typename F>
+  void for_each_slice_(const std::size_t& thread_count, F&& fn) noexcept;
+
+  // the table is cleared in contiguous slices by thread_count threads
+  void clear(const std::size_t& thread_count = 1) noexcept;
+  void resize(const std::size_t& size, const std::size_t& thread_count = 1) noexcept;
+
+  // reallocates (and hence clears) the table when the page size changes. large pages are 2MB pages,
+  // or 1GB pages for tables of at least 1GB when a 1GB hugetlb pool is configured. returns the
+  // region backing the table, which is invalid when the table fell back to new[].
+  [[maybe_unused]] util::large_pages::region use_large_pages(const bool& value, const std::size_t& thread_count = 1) noexcept;
+
+  // the signature identifies the network whose evaluations are cached in the table. a loaded table is
+  // resized to the size it was saved with, which must be a whole number of megabytes.
+  [[nodiscard]] bool save(const std::string& path, const std::uint32_t& signature) const noexcept;
+  [[nodiscard]] transposition_table_file_status load(const std::string& path, const std::uint32_t& signature, const std::size_t& thread_count = 1) noexcept;
+
+  // places the table in the named POSIX shared memory segment, attaching to it when another process
+  // already holds a table of the same size there. an empty name returns to a private table. shared
+  // tables are never cleared, as other processes may still be using their entries. returns the
+  // segment, which is invalid when the table fell back to a private allocation.
+  [[maybe_unused]] const util::shared_memory::segment& use_shared_memory(const std::string& name, const std::size_t& thread_count = 1) noexcept;
   void update_gen() noexcept;
 
   __attribute__((no_sanitize("thread"))) [[maybe_unused]] transposition_table& insert(
@@ -202,7 +313,16 @@ struct transposition_table {
 
   __attribute__((no_sanitize("thread"))) [[nodiscard]] std::optional<transposition_table_entry> find(const zobrist::hash_type& key) noexcept;
 
-  explicit transposition_table(const std::size_t& size) noexcept : data(size * one_mb) {}
+  // estimates are taken over the first sample_buckets buckets (or the whole table if smaller), which
+  // hash_function fills as uniformly as any other range
+  __attribute__((no_sanitize("thread"))) [[nodiscard]] transposition_table_stats stats(const std::size_t& sample_buckets = stats_sample_buckets) const noexcept;
+  [[nodiscard]] std::size_t hashfull() const noexcept { return stats(hashfull_sample_buckets).hashfull(); }
+
+  transposition_table(const transposition_table&) = delete;
+  transposition_table& operator=(const transposition_table&) = delete;
+
+  explicit transposition_table(const std::size_t& size, const std::size_t& thread_count = 1) noexcept { resize(size, thread_count); }
+  ~transposition_table() noexcept { deallocate_(); }
 };
 
 }  // namespace search
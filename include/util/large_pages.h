@@ -0,0 +1,153 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace util::large_pages {
+
+constexpr std::size_t small_page_size = static_cast<std::size_t>(4) * 1024;
+constexpr std::size_t huge_page_size = static_cast<std::size_t>(2) * 1024 * 1024;
+constexpr std::size_t gigantic_page_size = static_cast<std::size_t>(1024) * 1024 * 1024;
+
+enum class page_kind { small, transparent, explicit_huge, explicit_gigantic };
+
+[[nodiscard]] constexpr std::string_view name(const page_kind& kind) noexcept {
+  switch (kind) {
+    case page_kind::explicit_gigantic: return "hugetlb 1GB";
+    case page_kind::explicit_huge: return "hugetlb";
+    case page_kind::transparent: return "transparent";
+    default: return "none";
+  }
+}
+
+struct region {
+  void* data{nullptr};
+  std::size_t size{0};
+  page_kind kind{page_kind::small};
+
+  [[nodiscard]] bool is_valid() const noexcept { return data != nullptr; }
+};
+
+[[nodiscard]] constexpr std::size_t round_up(const std::size_t& size, const std::size_t& page_size = huge_page_size) noexcept {
+  return (size + page_size - 1) / page_size * page_size;
+}
+
+// attempts an explicit MAP_HUGETLB mapping first, which requires a preallocated huge page
+// pool, then falls back to a 2MB aligned anonymous mapping advised with MADV_HUGEPAGE.
+// allocations of at least a gigantic page first try 1GB pages when allow_gigantic is set,
+// which requires a preallocated 1GB pool. returns an invalid region when none of these is
+// supported, in which case callers should use a regular allocation.
+[[nodiscard]] inline region allocate(const std::size_t& size, const bool& allow_gigantic = false) noexcept {
+#if defined(__linux__)
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_1GB)
+  if (allow_gigantic && size >= gigantic_page_size) {
+    const std::size_t gigantic_size = round_up(size, gigantic_page_size);
+    void* gigantic =
+        ::mmap(nullptr, gigantic_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_1GB, -1, 0);
+    if (gigantic != MAP_FAILED) { return region{gigantic, gigantic_size, page_kind::explicit_gigantic}; }
+  }
+#else
+  static_cast<void>(allow_gigantic);
+#endif
+
+  const std::size_t rounded_size = round_up(size);
+
+#if defined(MAP_HUGETLB)
+  void* explicit_huge = ::mmap(nullptr, rounded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (explicit_huge != MAP_FAILED) { return region{explicit_huge, rounded_size, page_kind::explicit_huge}; }
+#endif
+
+  void* raw = ::mmap(nullptr, rounded_size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) { return region{}; }
+
+  const std::uintptr_t raw_begin = reinterpret_cast<std::uintptr_t>(raw);
+  const std::uintptr_t aligned_begin = (raw_begin + huge_page_size - 1) / huge_page_size * huge_page_size;
+  const std::size_t head = aligned_begin - raw_begin;
+  const std::size_t tail = huge_page_size - head;
+
+  if (head != 0) { ::munmap(raw, head); }
+  if (tail != 0) { ::munmap(reinterpret_cast<void*>(aligned_begin + rounded_size), tail); }
+
+  void* aligned = reinterpret_cast<void*>(aligned_begin);
+#if defined(MADV_HUGEPAGE)
+  ::madvise(aligned, rounded_size, MADV_HUGEPAGE);
+#endif
+
+  return region{aligned, rounded_size, page_kind::transparent};
+#else
+  static_cast<void>(size);
+  static_cast<void>(allow_gigantic);
+  return region{};
+#endif
+}
+
+inline void deallocate(const region& r) noexcept {
+#if defined(__linux__)
+  if (r.is_valid()) { ::munmap(r.data, r.size); }
+#else
+  static_cast<void>(r);
+#endif
+}
+
+// number of bytes of the region currently backed by huge pages. transparent huge pages are
+// only assigned on first touch and may silently be denied, so this is queried after the
+// region is populated.
+[[nodiscard]] inline std::size_t huge_page_bytes(const region& r) noexcept {
+  if (r.kind == page_kind::explicit_huge || r.kind == page_kind::explicit_gigantic) { return r.size; }
+  if (r.kind == page_kind::small) { return 0; }
+
+  std::ifstream smaps("/proc/self/smaps");
+  const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(r.data);
+  const std::uintptr_t end = begin + r.size;
+
+  std::size_t result{0};
+  bool in_region{false};
+
+  for (std::string line{}; std::getline(smaps, line);) {
+    std::uintptr_t mapping_begin{};
+    std::uintptr_t mapping_end{};
+    char separator{};
+
+    std::istringstream header(line);
+    if (header >> std::hex >> mapping_begin >> separator >> mapping_end && separator == '-') {
+      in_region = mapping_begin < end && begin < mapping_end;
+      continue;
+    }
+
+    constexpr std::string_view anon_huge_pages = "AnonHugePages:";
+    if (in_region && line.compare(0, anon_huge_pages.size(), anon_huge_pages) == 0) {
+      std::size_t kilobytes{};
+      std::istringstream(line.substr(anon_huge_pages.size())) >> kilobytes;
+      result += kilobytes * 1024;
+    }
+  }
+
+  return result;
+}
+
+}  // namespace util::large_pages
@@ -0,0 +1,165 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace util::shared_memory {
+
+// a named POSIX shared memory segment. the first page holds a control block counting the
+// processes attached to the segment, and the payload follows it page aligned. the control
+// block is only accessed while holding an flock on the segment, which serialises attaching,
+// detaching and removing the name.
+struct control_block {
+  static constexpr std::uint64_t expected_magic = 0x6d68737265657321;
+
+  std::uint64_t magic;
+  std::uint64_t payload_size;
+  std::uint32_t attached;
+};
+
+constexpr std::size_t control_size = static_cast<std::size_t>(4) * 1024;
+static_assert(sizeof(control_block) <= control_size);
+
+struct segment {
+  void* data{nullptr};
+  std::size_t size{0};
+  std::string name{};
+  std::uint32_t attached{0};
+  int fd{-1};
+
+  [[nodiscard]] bool is_valid() const noexcept { return data != nullptr; }
+  [[nodiscard]] control_block* control() const noexcept { return static_cast<control_block*>(data); }
+  [[nodiscard]] void* payload() const noexcept { return static_cast<unsigned char*>(data) + control_size; }
+};
+
+// POSIX requires shared memory names to begin with a single slash
+[[nodiscard]] inline std::string normalized_name(const std::string& name) noexcept { return name.front() == '/' ? name : "/" + name; }
+
+#if defined(__linux__)
+// whether name still refers to the object open as fd, which fails once the last process to detach
+// has removed the name (possibly followed by another process creating a new object under it)
+[[nodiscard]] inline bool is_named(const int& fd, const std::string& name) noexcept {
+  const int named_fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+  if (named_fd < 0) { return false; }
+
+  struct stat named_stat {};
+  struct stat fd_stat {};
+  const bool result = ::fstat(named_fd, &named_stat) == 0 && ::fstat(fd, &fd_stat) == 0 && named_stat.st_dev == fd_stat.st_dev &&
+                      named_stat.st_ino == fd_stat.st_ino;
+
+  ::close(named_fd);
+  return result;
+}
+#endif
+
+// attaches to the segment with the given name, creating it when no other process holds it. a
+// created payload is zero filled. returns an invalid segment when shared memory is unsupported or
+// when an existing segment has a different payload size.
+[[nodiscard]] inline segment attach(const std::string& name, const std::size_t& payload_size) noexcept {
+#if defined(__linux__)
+  if (name.empty()) { return segment{}; }
+
+  const std::string shm_name = normalized_name(name);
+  const std::size_t size = control_size + payload_size;
+
+  for (;;) {
+    const int fd = ::shm_open(shm_name.c_str(), O_RDWR | O_CREAT, 0600);
+    if (fd < 0) { return segment{}; }
+
+    const auto fail = [fd, &shm_name](const bool& remove = false) {
+      if (remove) { ::shm_unlink(shm_name.c_str()); }
+      ::flock(fd, LOCK_UN);
+      ::close(fd);
+      return segment{};
+    };
+
+    if (::flock(fd, LOCK_EX) != 0) { return fail(); }
+
+    // the object was removed by its last process between opening and locking it
+    if (!is_named(fd, shm_name)) {
+      ::flock(fd, LOCK_UN);
+      ::close(fd);
+      continue;
+    }
+
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0) { return fail(); }
+
+    // an empty object is either newly created or was left behind by a creator which failed before sizing it
+    const bool created = file_stat.st_size == 0;
+    if (created && ::ftruncate(fd, static_cast<off_t>(size)) != 0) { return fail(true); }
+    if (!created && static_cast<std::size_t>(file_stat.st_size) != size) { return fail(); }
+
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) { return fail(created); }
+
+    segment result{data, size, shm_name, 0, fd};
+    control_block* control = result.control();
+
+    if (created) {
+      control->magic = control_block::expected_magic;
+      control->payload_size = payload_size;
+    }
+
+    if (control->magic != control_block::expected_magic || control->payload_size != payload_size) {
+      ::munmap(data, size);
+      return fail();
+    }
+
+    result.attached = ++control->attached;
+    ::flock(fd, LOCK_UN);
+    return result;
+  }
+#else
+  static_cast<void>(name);
+  static_cast<void>(payload_size);
+  return segment{};
+#endif
+}
+
+// the last process to detach removes the segment. a process which exits without detaching (for
+// instance when killed) leaves the segment behind until it is removed from /dev/shm.
+inline void detach(const segment& s) noexcept {
+#if defined(__linux__)
+  if (!s.is_valid()) { return; }
+
+  ::flock(s.fd, LOCK_EX);
+  const bool is_last = --s.control()->attached == 0;
+  if (is_last && is_named(s.fd, s.name)) { ::shm_unlink(s.name.c_str()); }
+
+  ::munmap(s.data, s.size);
+  ::flock(s.fd, LOCK_UN);
+  ::close(s.fd);
+#else
+  static_cast<void>(s);
+#endif
+}
+
+}  // namespace util::shared_memory
@@ -0,0 +1,184 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chess/castle_info.h>
+#include <chess/packed_board.h>
+#include <chess/pawn_info.h>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace chess {
+
+namespace {
+
+constexpr std::size_t bits_per_byte = 8;
+
+template <typename T>
+void write_little_endian(const T& value, std::uint8_t* data) noexcept {
+  using unsigned_type = std::make_unsigned_t<T>;
+  const auto bits = static_cast<unsigned_type>(value);
+  for (std::size_t i(0); i < sizeof(T); ++i) { data[i] = static_cast<std::uint8_t>(bits >> (bits_per_byte * i)); }
+}
+
+template <typename T>
+[[nodiscard]] T read_little_endian(const std::uint8_t* data) noexcept {
+  using unsigned_type = std::make_unsigned_t<T>;
+  unsigned_type bits{};
+  for (std::size_t i(0); i < sizeof(T); ++i) { bits |= static_cast<unsigned_type>(static_cast<unsigned_type>(data[i]) << (bits_per_byte * i)); }
+  return static_cast<T>(bits);
+}
+
+[[nodiscard]] std::uint8_t nibble_at(const std::uint8_t* pieces, const std::size_t& idx) noexcept { return (pieces[idx / 2] >> (4 * (idx % 2))) & 0xf; }
+
+template <color c>
+[[nodiscard]] bool is_consistent_side(const board& bd) noexcept {
+  const auto& man = bd.man_.us<c>();
+  const auto& lat = bd.lat_.us<c>();
+  if (man.king().count() != 1) { return false; }
+
+  const bool king_on_start = man.king().is_member(castle_info<c>.start_king);
+  if (lat.oo() && !(king_on_start && man.rook().is_member(castle_info<c>.oo_rook))) { return false; }
+  if (lat.ooo() && !(king_on_start && man.rook().is_member(castle_info<c>.ooo_rook))) { return false; }
+  return true;
+}
+
+// the ep square must lie behind a pawn of the side not to move which could have just double pushed
+[[nodiscard]] bool is_consistent_ep(const board& bd, const std::uint8_t& ep_square) noexcept {
+  if (ep_square == packed_board::no_ep_square) { return true; }
+
+  const int ep_rank = bd.turn() ? pawn_info<color::black>::double_rank_idx + 1 : pawn_info<color::white>::double_rank_idx - 1;
+  const int direction = bd.turn() ? -1 : 1;
+
+  const square ep = square::from_index(ep_square);
+  if (ep.rank() != ep_rank) { return false; }
+
+  const square pushed = square::from_index(static_cast<int>(ep_square) + direction * 8);
+  const square origin = square::from_index(static_cast<int>(ep_square) - direction * 8);
+  const square_set occ = bd.man_.white.all() | bd.man_.black.all();
+
+  return bd.man_.them(bd.turn()).pawn().is_member(pushed) && !occ.is_member(ep) && !occ.is_member(origin);
+}
+
+// exactly one king per side, no pawns on the first or last rank, castling rights backed by an
+// unmoved king and rook, a plausible ep square and the side not to move not in check
+[[nodiscard]] bool is_consistent(const board& bd, const std::uint8_t& ep_square) noexcept {
+  const square_set back_ranks = generate_rank(0) | generate_rank(7);
+  if (((bd.man_.white.pawn() | bd.man_.black.pawn()) & back_ranks).any()) { return false; }
+  if (!is_consistent_side<color::white>(bd) || !is_consistent_side<color::black>(bd)) { return false; }
+  if (!is_consistent_ep(bd, ep_square)) { return false; }
+
+  board passed = bd;
+  ++passed.lat_.ply_count;
+  return !passed.is_check();
+}
+
+}  // namespace
+
+void packed_board::write_to(std::uint8_t* data) const noexcept {
+  write_little_endian(occupancy, data);
+  std::copy(std::begin(pieces), std::end(pieces), data + 8);
+  data[24] = state;
+  data[25] = ep_square;
+  data[26] = half_clock;
+  write_little_endian(ply_count, data + 27);
+  write_little_endian(score, data + 29);
+  write_little_endian(result, data + 31);
+}
+
+packed_board packed_board::read_from(const std::uint8_t* data) noexcept {
+  packed_board record{};
+  record.occupancy = read_little_endian<std::uint64_t>(data);
+  std::copy(data + 8, data + 24, std::begin(record.pieces));
+  record.state = data[24];
+  record.ep_square = data[25];
+  record.half_clock = data[26];
+  record.ply_count = read_little_endian<std::uint16_t>(data + 27);
+  record.score = read_little_endian<std::int16_t>(data + 29);
+  record.result = read_little_endian<std::int8_t>(data + 31);
+  return record;
+}
+
+bool packed_board::is_valid() const noexcept { return unpacked().has_value(); }
+
+std::optional<board> packed_board::unpacked() const noexcept {
+  constexpr std::uint8_t num_piece_types = static_cast<std::uint8_t>(piece_type::king) + 1;
+
+  const std::size_t num_pieces = square_set(occupancy).count();
+  if (num_pieces > max_pieces || ep_square > no_ep_square) { return std::nullopt; }
+
+  for (std::size_t idx(0); idx < num_pieces; ++idx) {
+    if ((nibble_at(pieces, idx) & 0x7) >= num_piece_types) { return std::nullopt; }
+  }
+
+  board bd{};
+
+  std::size_t idx{0};
+  for (const auto sq : square_set(occupancy)) {
+    const std::uint8_t nibble = nibble_at(pieces, idx);
+    const bool is_black = static_cast<bool>(nibble >> 3);
+    const auto pt = static_cast<piece_type>(nibble & 0x7);
+    bd.man_.us(!is_black).add_piece(pt, sq);
+    ++idx;
+  }
+
+  bd.lat_.white.set_oo(static_cast<bool>(state & (1 << 1)));
+  bd.lat_.white.set_ooo(static_cast<bool>(state & (1 << 2)));
+  bd.lat_.black.set_oo(static_cast<bool>(state & (1 << 3)));
+  bd.lat_.black.set_ooo(static_cast<bool>(state & (1 << 4)));
+
+  bd.lat_.half_clock = half_clock;
+  bd.lat_.ply_count = ply_count;
+  if (bd.turn() != turn()) { return std::nullopt; }
+  if (!is_consistent(bd, ep_square)) { return std::nullopt; }
+  if (ep_square != no_ep_square) { bd.lat_.them(turn()).set_ep_mask(square::from_index(ep_square)); }
+
+  return bd;
+}
+
+std::optional<packed_board> packed_board::from(const board& bd) noexcept {
+  packed_board record{};
+  record.occupancy = (bd.man_.white.all() | bd.man_.black.all()).data;
+  if (square_set(record.occupancy).count() > max_pieces) { return std::nullopt; }
+
+  std::size_t idx{0};
+  for (const auto sq : square_set(record.occupancy)) {
+    const bool is_black = bd.man_.black.all().is_member(sq);
+    const piece_type pt = is_black ? bd.man_.black.occ(sq) : bd.man_.white.occ(sq);
+    const auto nibble = static_cast<std::uint8_t>((static_cast<std::uint8_t>(is_black) << 3) | static_cast<std::uint8_t>(pt));
+    record.pieces[idx / 2] |= static_cast<std::uint8_t>(nibble << (4 * (idx % 2)));
+    ++idx;
+  }
+
+  record.state = static_cast<std::uint8_t>(
+      static_cast<std::uint8_t>(bd.turn()) | (static_cast<std::uint8_t>(bd.lat_.white.oo()) << 1) | (static_cast<std::uint8_t>(bd.lat_.white.ooo()) << 2) |
+      (static_cast<std::uint8_t>(bd.lat_.black.oo()) << 3) | (static_cast<std::uint8_t>(bd.lat_.black.ooo()) << 4));
+
+  const square_set ep_mask = bd.lat_.them(bd.turn()).ep_mask();
+  if (ep_mask.any()) { record.ep_square = static_cast<std::uint8_t>(ep_mask.item().index()); }
+
+  record.half_clock = static_cast<std::uint8_t>(std::min<std::size_t>(bd.lat_.half_clock, std::numeric_limits<std::uint8_t>::max()));
+
+  // clamping preserves the parity of ply_count and hence the side to move
+  constexpr std::size_t max_ply_count = std::numeric_limits<std::uint16_t>::max();
+  record.ply_count = static_cast<std::uint16_t>(std::min(bd.lat_.ply_count, max_ply_count - 1 + bd.lat_.ply_count % 2));
+
+  return record;
+}
+
+}  // namespace chess
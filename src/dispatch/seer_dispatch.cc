@@ -0,0 +1,89 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstddef>
+#include <iostream>
+
+// each tier is a partially linked copy of the whole engine in which every symbol
+// except its entry point is local. the static initializers of a tier are moved
+// out of .init_array into a tier specific section and only run for the selected tier,
+// since they may already contain instructions the host does not support.
+
+#define SEER_DECLARE_TIER(name)                                             \
+  int seer_main_##name(const int argc, const char* argv[]);                 \
+  extern void (*const __start_seer_init_##name[])() __attribute__((weak)); \
+  extern void (*const __stop_seer_init_##name[])() __attribute__((weak));
+
+extern "C" {
+SEER_DECLARE_TIER(avx512vnni)
+SEER_DECLARE_TIER(avx512bw)
+SEER_DECLARE_TIER(avx2)
+SEER_DECLARE_TIER(ssse3)
+}
+
+#undef SEER_DECLARE_TIER
+
+namespace dispatch {
+
+using entry_type = int (*)(const int, const char*[]);
+using initializer_type = void (*)();
+
+struct tier {
+  bool supported;
+  entry_type entry;
+  const initializer_type* init_begin;
+  const initializer_type* init_end;
+
+  int operator()(const int argc, const char* argv[]) const {
+    for (const initializer_type* init = init_begin; init != init_end; ++init) { (*init)(); }
+    return entry(argc, argv);
+  }
+};
+
+inline bool supports_avx512bw() noexcept {
+  return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl") &&
+         __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512cd");
+}
+
+inline bool supports_avx512vnni() noexcept { return supports_avx512bw() && __builtin_cpu_supports("avx512vnni"); }
+
+inline bool supports_avx2() noexcept {
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("popcnt");
+}
+
+inline bool supports_ssse3() noexcept { return __builtin_cpu_supports("ssse3"); }
+
+}  // namespace dispatch
+
+int main(const int argc, const char* argv[]) {
+  using namespace dispatch;
+  __builtin_cpu_init();
+
+  const tier tiers[] = {
+      tier{supports_avx512vnni() && supports_avx2(), seer_main_avx512vnni, __start_seer_init_avx512vnni, __stop_seer_init_avx512vnni},
+      tier{supports_avx512bw() && supports_avx2(), seer_main_avx512bw, __start_seer_init_avx512bw, __stop_seer_init_avx512bw},
+      tier{supports_avx2(), seer_main_avx2, __start_seer_init_avx2, __stop_seer_init_avx2},
+      tier{supports_ssse3(), seer_main_ssse3, __start_seer_init_ssse3, __stop_seer_init_ssse3},
+  };
+
+  for (const tier& candidate : tiers) {
+    if (candidate.supported) { return candidate(argc, argv); }
+  }
+
+  std::cerr << "seer requires at least ssse3 support" << std::endl;
+  return 1;
+}
@@ -0,0 +1,137 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chess/board.h>
+#include <engine/analysis.h>
+#include <engine/time_manager.h>
+#include <search/search_worker.h>
+#include <search/transposition_table.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace engine {
+
+namespace {
+
+// scores are written as in UCI info lines: "cp <centipawns>" or "mate <moves>", negative when mated
+void write_score(std::ostream& os, const search::score_type& score) noexcept {
+  const bool is_loss = score <= search::max_mate_score;
+  const bool is_win = score >= -search::max_mate_score;
+
+  if (!is_loss && !is_win) {
+    os << "cp " << search::to_centipawns(score);
+    return;
+  }
+
+  const search::score_type plies = is_loss ? (score - search::mate_score) : (-score - search::mate_score);
+  const search::score_type moves = (plies + 1) / 2;
+  os << "mate " << (is_loss ? -moves : moves);
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const analysis_info& info) noexcept {
+  return os << info.positions << " positions " << info.positions_per_second << " positions/s " << info.total_nodes << " nodes "
+            << info.nodes_per_second << " nps";
+}
+
+analysis_info get_analysis_info(
+    const nnue::quantized_weights& weights,
+    const std::string& input_path,
+    const std::string& output_path,
+    const analysis_limit& limit,
+    const std::size_t& thread_count) noexcept {
+  using worker_type = search::search_worker;
+
+  std::ifstream input(input_path);
+  std::ofstream output(output_path);
+  if (!input || !output) { return analysis_info{}; }
+
+  std::vector<std::string> fens{};
+  for (std::string fen{}; std::getline(input, fen);) {
+    if (!fen.empty()) { fens.push_back(fen); }
+  }
+
+  std::shared_ptr<search::search_constants> constants = std::make_shared<search::search_constants>(1);
+
+  std::atomic_size_t next_idx{0};
+  std::atomic_size_t total_nodes{0};
+  std::mutex output_mutex{};
+
+  simple_timer<std::chrono::milliseconds> timer{};
+
+  // each worker keeps its scratchpad, histories and reset cache across the positions it searches
+  auto analyse = [&] {
+    std::shared_ptr<search::transposition_table> tt = std::make_shared<search::transposition_table>(analysis_config::tt_mb_size);
+    std::unique_ptr<worker_type> worker{};
+
+    const search::search_worker_external_state external_state(
+        &weights,
+        tt,
+        constants,
+        [&](const auto& w) {
+          if (limit.type == analysis_limit_type::depth && static_cast<std::size_t>(w.depth()) >= limit.value) { worker->stop(); }
+        },
+        [&](const auto& w) {
+          if (limit.type == analysis_limit_type::nodes && w.nodes() >= limit.value) { worker->stop(); }
+        });
+
+    worker = std::make_unique<worker_type>(external_state);
+
+    for (std::size_t idx = next_idx++; idx < fens.size(); idx = next_idx++) {
+      const chess::board bd = chess::board::parse_fen(fens[idx]);
+
+      // there is nothing to search in checkmated and stalemated positions
+      if (bd.generate_moves<>().empty()) {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        output << fens[idx] << ';' << (bd.is_check() ? "mate 0" : "cp 0") << ";;0;\n";
+        continue;
+      }
+
+      tt->update_gen();
+      worker->go(chess::board_history{}, bd, analysis_config::init_depth);
+      worker->iterative_deepening_loop();
+
+      total_nodes += worker->nodes();
+
+      const std::string pv = worker->internal.stack.pv_string(worker->internal.lines.front().pv);
+
+      std::lock_guard<std::mutex> lock(output_mutex);
+      output << fens[idx] << ';';
+      write_score(output, worker->score());
+      output << ';' << worker->best_move().name(bd.turn()) << ';' << worker->nodes() << ';' << pv << '\n';
+    }
+  };
+
+  std::vector<std::thread> threads{};
+  for (std::size_t i(0); i < std::max<std::size_t>(1, thread_count); ++i) { threads.emplace_back(analyse); }
+  for (auto& thread : threads) { thread.join(); }
+
+  const std::size_t elapsed_ms = 1 + timer.elapsed().count();
+  const std::size_t ms_per_second = std::chrono::milliseconds(std::chrono::seconds(1)).count();
+
+  return analysis_info{true, fens.size(), total_nodes.load(), ms_per_second * fens.size() / elapsed_ms, ms_per_second * total_nodes.load() / elapsed_ms};
+}
+
+}  // namespace engine
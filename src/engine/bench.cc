@@ -15,7 +15,22 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <chess/packed_board.h>
 #include <engine/bench.h>
+#include <engine/packed_board_file.h>
+#include <util/string.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <vector>
 
 namespace engine {
 
@@ -23,44 +38,279 @@ std::ostream& operator<<(std::ostream& os, const bench_info& info) noexcept {
   return os << info.total_nodes << " nodes " << info.nodes_per_second << " nps";
 }
 
-bench_info get_bench_info(const nnue::quantized_weights& weights) noexcept {
-  using worker_type = search::search_worker;
-  std::shared_ptr<search::search_constants> constants = std::make_shared<search::search_constants>(1);
-  std::shared_ptr<search::transposition_table> tt = std::make_shared<search::transposition_table>(bench_config::tt_mb_size);
+bench_options bench_options::parse(const std::string& args) noexcept {
+  bench_options options{};
+  std::istringstream tokens(args);
+
+  for (std::string token{}; tokens >> token;) {
+    if (token == "depth") { tokens >> options.depth; }
+    if (token == "threads") { tokens >> options.thread_count; }
+    if (token == "hash") { tokens >> options.tt_mb_size; }
+    if (token == "positions") { tokens >> options.positions_path; }
+    if (token == "json") { options.json = true; }
+  }
+
+  options.depth = std::clamp(options.depth, search::depth_type{1}, search::max_depth);
+  options.thread_count = std::max(options.thread_count, std::size_t{1});
+  options.tt_mb_size = std::max(options.tt_mb_size, std::size_t{1});
+  return options;
+}
+
+namespace {
+
+std::string json_escaped(const std::string& value) noexcept {
+  std::ostringstream result{};
+  for (const char& c : value) {
+    switch (c) {
+      case '"': result << "\\\""; break;
+      case '\\': result << "\\\\"; break;
+      case '\n': result << "\\n"; break;
+      case '\r': result << "\\r"; break;
+      case '\t': result << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          result << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+          result << c;
+        }
+    }
+  }
+  return result.str();
+}
+
+}  // namespace
+
+void bench_report::write_json(std::ostream& os) const noexcept {
+  os << "{\"depth\":" << options.depth << ",\"threads\":" << options.thread_count << ",\"hash\":" << options.tt_mb_size << ",\"positions\":[";
+
+  for (std::size_t i(0); i < positions.size(); ++i) {
+    const bench_position_info& position = positions[i];
+    if (i != 0) { os << ','; }
+    os << "\n{\"fen\":\"" << json_escaped(position.fen) << "\",\"nodes\":" << position.nodes << ",\"time_ms\":" << position.elapsed_ms
+       << ",\"nps\":" << position.nodes_per_second << ",\"depth\":" << position.depth << ",\"best_move\":\"" << json_escaped(position.best_move) << "\"}";
+  }
+
+  os << "],\n\"total\":{\"nodes\":" << total.total_nodes << ",\"time_ms\":" << elapsed_ms << ",\"nps\":" << total.nodes_per_second << "}}";
+}
+
+std::string fen_from_epd(const std::string& line) noexcept {
+  constexpr std::size_t num_position_tokens = chess::board::num_fen_tokens - 2;
+
+  std::istringstream tokens(line.substr(0, line.find(';')));
+  std::vector<std::string> fields{};
+  for (std::string token{}; fields.size() < chess::board::num_fen_tokens && tokens >> token;) { fields.push_back(token); }
+  if (fields.size() < num_position_tokens) { return std::string{}; }
+
+  const auto is_number = [](const std::string& field) { return std::all_of(field.begin(), field.end(), [](const char& c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; }); };
+  const bool has_counters = fields.size() == chess::board::num_fen_tokens && is_number(fields[4]) && is_number(fields[5]);
+
+  if (!has_counters) {
+    fields.resize(num_position_tokens);
+    fields.insert(fields.end(), {"0", "1"});
+  }
+
+  return util::string::join(fields.begin(), fields.end(), " ");
+}
+
+bench_report get_bench_report(const nnue::quantized_weights& weights, const bench_options& options) noexcept {
+  bench_report report{false, options};
+  std::vector<std::string> fens(bench_config::fens.begin(), bench_config::fens.end());
 
-  std::unique_ptr<worker_type> worker{};
-  const search::search_worker_external_state external_state(&weights, tt, constants, [&](const auto& w) {
-    if (w.depth() >= bench_config::bench_depth) { worker->stop(); }
+  if (!options.positions_path.empty()) {
+    std::ifstream input(options.positions_path);
+    if (!input) { return report; }
+
+    fens.clear();
+    for (std::string line{}; std::getline(input, line);) {
+      if (const std::string fen = fen_from_epd(line); !fen.empty()) { fens.push_back(fen); }
+    }
+  }
+
+  std::unique_ptr<search::worker_orchestrator> orchestrator{};
+  orchestrator = std::make_unique<search::worker_orchestrator>(&weights, options.tt_mb_size, [&](const auto& w) {
+    if (w.depth() >= options.depth) { orchestrator->stop(); }
   });
 
-  worker = std::make_unique<worker_type>(external_state);
+  orchestrator->resize(options.thread_count);
 
-  simple_timer<std::chrono::milliseconds> timer{};
-  std::size_t total_nodes{};
+  const auto per_second = [](const std::size_t& nodes, const std::size_t& elapsed_ms) {
+    return nodes * std::chrono::milliseconds(std::chrono::seconds(1)).count() / std::max(elapsed_ms, std::size_t{1});
+  };
 
-  for (const auto& fen : bench_config::fens) {
-    worker->go(chess::board_history{}, chess::board::parse_fen(std::string(fen)), bench_config::init_depth);
-    worker->iterative_deepening_loop();
-    total_nodes += worker->nodes();
+  simple_timer<std::chrono::milliseconds> total_timer{};
+
+  for (const auto& fen : fens) {
+    const chess::board bd = chess::board::parse_fen(fen);
+    simple_timer<std::chrono::milliseconds> timer{};
+
+    orchestrator->go(chess::board_history{}, bd);
+    orchestrator->wait();
+
+    bench_position_info position{};
+    position.fen = bd.fen();
+    position.nodes = orchestrator->nodes();
+    position.elapsed_ms = static_cast<std::size_t>(timer.elapsed().count());
+    position.nodes_per_second = per_second(position.nodes, position.elapsed_ms);
+    // the primary worker advances its depth before observing the stop, so the last completed depth is one less
+    position.depth = orchestrator->primary_worker().depth() - 1;
+    position.best_move = orchestrator->primary_worker().best_move().name(bd.turn());
+
+    report.total.total_nodes += position.nodes;
+    report.positions.push_back(position);
+  }
+
+  report.success = true;
+  report.elapsed_ms = static_cast<std::size_t>(total_timer.elapsed().count());
+  report.total.nodes_per_second = per_second(report.total.total_nodes, report.elapsed_ms);
+  return report;
+}
+
+bench_info get_bench_info(const nnue::quantized_weights& weights) noexcept { return get_bench_report(weights, bench_options{}).total; }
+
+std::ostream& operator<<(std::ostream& os, const scale_bench_info& info) noexcept {
+  if (info.rows.empty()) { return os; }
+  const scale_bench_row& base = info.rows.front();
+
+  const auto ratio = [](const std::size_t& num, const std::size_t& den) { return static_cast<double>(num) / static_cast<double>(std::max(den, std::size_t{1})); };
+
+  os << "depth " << info.depth << '\n';
+  os << std::setw(8) << "threads" << std::setw(12) << "time_ms" << std::setw(14) << "nodes" << std::setw(12) << "nps" << std::setw(10) << "speedup"
+     << std::setw(12) << "efficiency" << std::setw(12) << "nodes_ratio" << std::setw(12) << "nps_ratio";
+
+  for (const auto& row : info.rows) {
+    const double speedup = ratio(base.elapsed_ms, row.elapsed_ms);
+    os << '\n' << std::setw(8) << row.thread_count << std::setw(12) << row.elapsed_ms << std::setw(14) << row.nodes << std::setw(12) << row.nodes_per_second;
+    os << std::fixed << std::setprecision(2) << std::setw(10) << speedup << std::setw(12) << speedup / static_cast<double>(row.thread_count);
+    os << std::setw(12) << ratio(row.nodes, base.nodes) << std::setw(12) << ratio(row.nodes_per_second, base.nodes_per_second);
+    os << std::defaultfloat;
   }
 
-  const std::size_t nodes_per_second = total_nodes * std::chrono::milliseconds(std::chrono::seconds(1)).count() / timer.elapsed().count();
+  return os;
+}
+
+scale_bench_info get_scale_bench_info(const nnue::quantized_weights& weights, const bench_options& options) noexcept {
+  scale_bench_info info{false, options.depth};
+
+  std::vector<std::size_t> thread_counts{};
+  for (std::size_t count(1); count < options.thread_count; count *= 2) { thread_counts.push_back(count); }
+  thread_counts.push_back(options.thread_count);
+
+  for (const auto& thread_count : thread_counts) {
+    bench_options run_options = options;
+    run_options.thread_count = thread_count;
+
+    const bench_report report = get_bench_report(weights, run_options);
+    if (!report.success) { return info; }
+
+    info.rows.push_back(scale_bench_row{thread_count, report.elapsed_ms, report.total.total_nodes, report.total.nodes_per_second});
+  }
 
-  return bench_info{total_nodes, nodes_per_second};
+  info.success = true;
+  return info;
 }
 
-std::size_t perft(const chess::board& bd, const search::depth_type& depth) noexcept {
-  if (depth == 0) { return bd.generate_moves<>().size(); }
-  std::size_t result{0};
-  for (const auto& mv : bd.generate_moves<>()) { result += perft(bd.forward(mv), depth - 1); }
-  return result;
+std::ostream& operator<<(std::ostream& os, const packed_board_bench_info& info) noexcept {
+  os << info.positions << " positions " << info.mismatches << " mismatches\n";
+  os << "parse_fen " << info.parse_fen_per_second << " positions/s\n";
+  os << "fen " << info.fen_per_second << " positions/s\n";
+  os << "unpack " << info.unpack_per_second << " positions/s\n";
+  os << "pack " << info.pack_per_second << " positions/s\n";
+  os << "file write " << info.file_write_per_second << " positions/s\n";
+  return os << "file read " << info.file_read_per_second << " positions/s";
 }
 
-bench_info get_perft_info(const chess::board& bd, const search::depth_type& depth) noexcept {
+packed_board_bench_info get_packed_board_bench_info() noexcept {
+  std::vector<chess::board> distinct{};
+
+  for (const auto& fen : bench_config::fens) {
+    const chess::board bd = chess::board::parse_fen(std::string(fen));
+    distinct.push_back(bd);
+    for (const auto& mv : bd.generate_moves<>()) { distinct.push_back(bd.forward(mv)); }
+  }
+
+  std::vector<std::string> fens{};
+  fens.reserve(bench_config::packed_board_bench_positions);
+  std::vector<std::uint8_t> packed(bench_config::packed_board_bench_positions * chess::packed_board::num_bytes);
+
+  for (std::size_t i(0); i < bench_config::packed_board_bench_positions; ++i) {
+    const chess::board& bd = distinct[i % distinct.size()];
+    fens.push_back(bd.fen());
+    chess::packed_board::from(bd)->write_to(packed.data() + i * chess::packed_board::num_bytes);
+  }
+
+  const auto per_second = [](const std::size_t& count, const std::chrono::nanoseconds& elapsed) {
+    return count * std::chrono::nanoseconds(std::chrono::seconds(1)).count() / std::max<std::size_t>(1, elapsed.count());
+  };
+
+  packed_board_bench_info info{};
+  info.positions = bench_config::packed_board_bench_positions;
+
+  // each timed loop checks its output, which both validates the encoding and keeps the loop from being
+  // optimized away
+  zobrist::hash_type parse_fen_checksum{};
+  zobrist::hash_type unpack_checksum{};
+
   simple_timer<std::chrono::nanoseconds> timer{};
-  const std::size_t nodes = perft(bd, depth - 1);
-  const std::size_t nodes_per_second = nodes * std::chrono::nanoseconds(std::chrono::seconds(1)).count() / timer.elapsed().count();
-  return bench_info{nodes, nodes_per_second};
+  for (const auto& fen : fens) { parse_fen_checksum ^= chess::board::parse_fen(fen).hash(); }
+  info.parse_fen_per_second = per_second(info.positions, timer.elapsed());
+
+  timer.lap();
+  for (std::size_t i(0); i < info.positions; ++i) {
+    if (distinct[i % distinct.size()].fen() != fens[i]) { ++info.mismatches; }
+  }
+  info.fen_per_second = per_second(info.positions, timer.elapsed());
+
+  timer.lap();
+  for (std::size_t i(0); i < info.positions; ++i) {
+    unpack_checksum ^= chess::packed_board::read_from(packed.data() + i * chess::packed_board::num_bytes).unpacked()->hash();
+  }
+  info.unpack_per_second = per_second(info.positions, timer.elapsed());
+
+  timer.lap();
+  for (std::size_t i(0); i < info.positions; ++i) {
+    std::uint8_t data[chess::packed_board::num_bytes];
+    chess::packed_board::from(distinct[i % distinct.size()])->write_to(data);
+    if (!std::equal(std::begin(data), std::end(data), packed.data() + i * chess::packed_board::num_bytes)) { ++info.mismatches; }
+  }
+  info.pack_per_second = per_second(info.positions, timer.elapsed());
+
+  // the same records are streamed through a file, which exercises the buffered writer and the
+  // memory mapped reader
+  const std::string file_path = (std::filesystem::temp_directory_path() / "seer_packbench.bin").string();
+  zobrist::hash_type file_checksum{};
+
+  timer.lap();
+  {
+    std::ofstream output(file_path, std::ios::binary);
+    packed_board_writer writer(&output);
+    for (std::size_t i(0); i < info.positions; ++i) { writer.write(distinct[i % distinct.size()]); }
+  }
+  info.file_write_per_second = per_second(info.positions, timer.elapsed());
+
+  timer.lap();
+  {
+    const packed_board_reader reader(file_path);
+    if (reader.size() != info.positions) { ++info.mismatches; }
+
+    for (const std::optional<chess::board> bd : reader) {
+      if (bd.has_value()) {
+        file_checksum ^= bd->hash();
+      } else {
+        ++info.mismatches;
+      }
+    }
+  }
+  info.file_read_per_second = per_second(info.positions, timer.elapsed());
+  std::remove(file_path.c_str());
+
+  for (const auto& bd : distinct) {
+    const std::optional<chess::board> round_trip = chess::packed_board::from(bd)->unpacked();
+    if (!round_trip.has_value() || round_trip->hash() != bd.hash() || round_trip->fen() != bd.fen()) { ++info.mismatches; }
+  }
+
+  if (parse_fen_checksum != unpack_checksum || parse_fen_checksum != file_checksum) { ++info.mismatches; }
+
+  return info;
 }
 
 }  // namespace engine
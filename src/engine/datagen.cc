@@ -0,0 +1,179 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chess/board_history.h>
+#include <chess/move_list.h>
+#include <chess/packed_board.h>
+#include <engine/datagen.h>
+#include <engine/packed_board_file.h>
+#include <engine/time_manager.h>
+#include <search/search_worker.h>
+#include <search/syzygy.h>
+#include <search/transposition_table.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace engine {
+
+namespace {
+
+enum class game_result { white_win, draw, black_win };
+
+[[nodiscard]] bool is_repetition(const chess::board_history& history, const chess::board& bd) noexcept {
+  const chess::sided_zobrist_hash hash = bd.sided_hash();
+  const std::size_t lookback = std::min(history.size(), bd.lat_.half_clock);
+
+  for (std::size_t i(1); i <= lookback; ++i) {
+    const chess::sided_zobrist_hash& other = history.at(history.size() - i);
+    if (other.white == hash.white && other.black == hash.black) { return true; }
+  }
+
+  return false;
+}
+
+[[nodiscard]] game_result win_for(const bool& pov) noexcept { return pov ? game_result::white_win : game_result::black_win; }
+
+[[nodiscard]] std::optional<game_result> adjudicate(const chess::board_history& history, const chess::board& bd, const std::size_t& ply) noexcept {
+  if (bd.generate_moves<>().empty()) { return bd.is_check() ? win_for(!bd.turn()) : game_result::draw; }
+  if (bd.is_rule50_draw() || bd.is_trivially_drawn() || is_repetition(history, bd) || ply >= datagen_config::max_plies) { return game_result::draw; }
+
+  if (const search::syzygy::tb_wdl_result result = search::syzygy::probe_wdl(bd); result.success) {
+    switch (result.wdl) {
+      case search::syzygy::wdl_type::loss: return win_for(!bd.turn());
+      case search::syzygy::wdl_type::win: return win_for(bd.turn());
+      default: return game_result::draw;
+    }
+  }
+
+  return std::nullopt;
+}
+
+[[nodiscard]] std::int8_t result_for(const game_result& result, const bool& pov) noexcept {
+  if (result == game_result::draw) { return 0; }
+  return (result == win_for(pov)) ? 1 : -1;
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const datagen_info& info) noexcept {
+  return os << info.games << " games " << info.positions << " positions " << info.positions_per_second << " positions/s";
+}
+
+datagen_info get_datagen_info(
+    const nnue::quantized_weights& weights,
+    const std::string& output_path,
+    const std::size_t& num_games,
+    const std::size_t& thread_count,
+    const std::size_t& node_limit) noexcept {
+  using worker_type = search::search_worker;
+
+  std::ofstream output(output_path, std::ios::binary);
+  if (!output) { return datagen_info{}; }
+
+  std::shared_ptr<search::search_constants> constants = std::make_shared<search::search_constants>(1);
+
+  std::atomic_size_t next_game{0};
+  std::atomic_size_t total_positions{0};
+  std::mutex output_mutex{};
+
+  simple_timer<std::chrono::milliseconds> timer{};
+
+  auto play = [&] {
+    std::shared_ptr<search::transposition_table> tt = std::make_shared<search::transposition_table>(datagen_config::tt_mb_size);
+    std::unique_ptr<worker_type> worker{};
+
+    const search::search_worker_external_state external_state(
+        &weights,
+        tt,
+        constants,
+        [&](const auto& w) {
+          if (w.nodes() >= node_limit || w.depth() >= search::max_depth) { worker->stop(); }
+        },
+        [&](const auto& w) {
+          if (w.nodes() >= node_limit) { worker->stop(); }
+        });
+
+    worker = std::make_unique<worker_type>(external_state);
+    packed_board_writer writer(&output, &output_mutex);
+
+    std::vector<chess::packed_board> records{};
+
+    for (std::size_t game = next_game++; game < num_games; game = next_game++) {
+      std::mt19937_64 generator(datagen_config::seed ^ game);
+
+      chess::board_history history{};
+      chess::board bd = chess::board::start_pos();
+
+      for (std::size_t ply(0); ply < datagen_config::random_plies; ++ply) {
+        const chess::move_list moves = bd.generate_moves<>();
+        if (moves.empty()) { break; }
+
+        history.push(bd.sided_hash());
+        bd = bd.forward(moves[std::uniform_int_distribution<std::size_t>(0, moves.size() - 1)(generator)]);
+      }
+
+      tt->clear();
+      worker->internal.reset();
+      records.clear();
+
+      std::optional<game_result> result = std::nullopt;
+
+      for (std::size_t ply(datagen_config::random_plies); !(result = adjudicate(history, bd, ply)).has_value(); ++ply) {
+        worker->go(history, bd, datagen_config::init_depth);
+        worker->iterative_deepening_loop();
+
+        if (std::optional<chess::packed_board> record = chess::packed_board::from(bd); record.has_value() && !bd.is_check()) {
+          constexpr search::score_type score_limit = std::numeric_limits<std::int16_t>::max();
+          record->score = static_cast<std::int16_t>(std::clamp(worker->score(), -score_limit, score_limit));
+          records.push_back(*record);
+        }
+
+        history.push(bd.sided_hash());
+        bd = bd.forward(worker->best_move());
+      }
+
+      // results are stored from the perspective of each record's side to move
+      for (auto& record : records) {
+        record.result = result_for(result.value(), record.turn());
+        writer.write(record);
+      }
+
+      total_positions += records.size();
+    }
+  };
+
+  std::vector<std::thread> threads{};
+  for (std::size_t i(0); i < std::max<std::size_t>(1, thread_count); ++i) { threads.emplace_back(play); }
+  for (auto& thread : threads) { thread.join(); }
+
+  const std::size_t elapsed_ms = 1 + timer.elapsed().count();
+  const std::size_t ms_per_second = std::chrono::milliseconds(std::chrono::seconds(1)).count();
+
+  return datagen_info{true, num_games, total_positions.load(), ms_per_second * total_positions.load() / elapsed_ms};
+}
+
+}  // namespace engine
@@ -0,0 +1,69 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <engine/packed_board_file.h>
+
+#include <fstream>
+#include <iterator>
+
+namespace engine {
+
+packed_board_reader::packed_board_reader(const std::string& path) noexcept : file_(path) {
+  if (file_.is_open()) {
+    data_ = file_.data();
+    size_ = file_.size() / chess::packed_board::num_bytes;
+    return;
+  }
+
+  std::ifstream input(path, std::ios::binary);
+  if (!input) { return; }
+
+  fallback_.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+  data_ = fallback_.data();
+  size_ = fallback_.size() / chess::packed_board::num_bytes;
+}
+
+void packed_board_writer::write(const chess::packed_board& record) noexcept {
+  const std::size_t offset = buffer_.size();
+  buffer_.resize(offset + chess::packed_board::num_bytes);
+  record.write_to(buffer_.data() + offset);
+
+  if (buffer_.size() >= packed_board_file_config::writer_buffer_size) { flush(); }
+}
+
+void packed_board_writer::flush() noexcept {
+  if (buffer_.empty()) { return; }
+
+  const auto append = [this] { output_->write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size())); };
+
+  if (output_mutex_ != nullptr) {
+    std::lock_guard<std::mutex> lock(*output_mutex_);
+    append();
+  } else {
+    append();
+  }
+
+  buffer_.clear();
+}
+
+packed_board_writer::packed_board_writer(std::ostream* output, std::mutex* output_mutex) noexcept : output_{output}, output_mutex_{output_mutex} {
+  buffer_.reserve(packed_board_file_config::writer_buffer_size + chess::packed_board::num_bytes);
+}
+
+packed_board_writer::~packed_board_writer() noexcept { flush(); }
+
+}  // namespace engine
@@ -0,0 +1,181 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chess/move_list.h>
+#include <engine/perft.h>
+#include <engine/time_manager.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace engine {
+
+bool perft_table::find(const zobrist::hash_type& key, const search::depth_type& depth, std::size_t& count) const noexcept {
+  const perft_table_entry& entry = data[hash_function(key)];
+  const std::uint64_t entry_data = entry.data_.load(std::memory_order_relaxed);
+  const zobrist::hash_type entry_key = entry.key_xor_data_.load(std::memory_order_relaxed) ^ entry_data;
+
+  if (entry_key != key || perft_table_entry::depth_::get(entry_data) != static_cast<perft_table_entry::depth_::type>(depth)) { return false; }
+
+  count = static_cast<std::size_t>(perft_table_entry::count_::get(entry_data));
+  return true;
+}
+
+void perft_table::insert(const zobrist::hash_type& key, const search::depth_type& depth, const std::size_t& count) noexcept {
+  std::uint64_t entry_data{};
+  perft_table_entry::count_::set(entry_data, static_cast<std::uint64_t>(count));
+  perft_table_entry::depth_::set(entry_data, static_cast<perft_table_entry::depth_::type>(depth));
+
+  perft_table_entry& entry = data[hash_function(key)];
+  entry.data_.store(entry_data, std::memory_order_relaxed);
+  entry.key_xor_data_.store(key ^ entry_data, std::memory_order_relaxed);
+}
+
+std::ostream& operator<<(std::ostream& os, const perft_divide_info& info) noexcept {
+  for (const auto& [mv, count] : info.counts) { os << mv.name(info.turn) << ": " << count << '\n'; }
+  return os << info.total;
+}
+
+std::ostream& operator<<(std::ostream& os, const perft_suite_info& info) noexcept {
+  return os << info.positions << " positions " << info.passed << " passed " << info.failed << " failed " << info.total;
+}
+
+std::size_t perft(const chess::board& bd, const search::depth_type& depth, perft_table* table) noexcept {
+  if (depth == 0) { return bd.generate_moves<>().size(); }
+
+  std::size_t result{0};
+  if (table != nullptr && table->find(bd.hash(), depth, result)) { return result; }
+
+  for (const auto& mv : bd.generate_moves<>()) { result += perft(bd.forward(mv), depth - 1, table); }
+  if (table != nullptr) { table->insert(bd.hash(), depth, result); }
+
+  return result;
+}
+
+perft_divide_info perft_divide(const chess::board& bd, const search::depth_type& depth, const std::size_t& thread_count, perft_table& table) noexcept {
+  struct work_item {
+    std::size_t root_idx;
+    chess::board bd;
+    search::depth_type depth;
+  };
+
+  simple_timer<std::chrono::nanoseconds> timer{};
+
+  const chess::move_list root_moves = bd.generate_moves<>();
+  std::vector<std::atomic_size_t> counts(root_moves.size());
+  std::vector<work_item> items{};
+
+  // positions depth - 2 plies above the leaves are only worth splitting further for deeper searches
+  for (std::size_t i(0); i < root_moves.size(); ++i) {
+    const chess::board child = bd.forward(root_moves[i]);
+
+    if (depth <= 2) {
+      items.push_back(work_item{i, child, depth - 1});
+    } else {
+      for (const auto& mv : child.generate_moves<>()) { items.push_back(work_item{i, child.forward(mv), depth - 2}); }
+    }
+  }
+
+  std::atomic_size_t next_item{0};
+
+  auto count_leaves = [&] {
+    for (std::size_t i = next_item++; i < items.size(); i = next_item++) {
+      const work_item& item = items[i];
+      const std::size_t count = (item.depth == 0) ? 1 : perft(item.bd, item.depth - 1, &table);
+      counts[item.root_idx].fetch_add(count, std::memory_order_relaxed);
+    }
+  };
+
+  std::vector<std::thread> threads{};
+  for (std::size_t i(0); i < std::max<std::size_t>(1, thread_count); ++i) { threads.emplace_back(count_leaves); }
+  for (auto& thread : threads) { thread.join(); }
+
+  perft_divide_info info{bd.turn()};
+  for (std::size_t i(0); i < root_moves.size(); ++i) {
+    info.counts.emplace_back(root_moves[i], counts[i].load());
+    info.total.total_nodes += counts[i].load();
+  }
+
+  info.total.nodes_per_second =
+      info.total.total_nodes * std::chrono::nanoseconds(std::chrono::seconds(1)).count() / std::max<std::size_t>(1, timer.elapsed().count());
+  return info;
+}
+
+bench_info get_perft_info(const chess::board& bd, const search::depth_type& depth, const std::size_t& thread_count) noexcept {
+  return get_perft_divide_info(bd, depth, thread_count).total;
+}
+
+perft_divide_info get_perft_divide_info(const chess::board& bd, const search::depth_type& depth, const std::size_t& thread_count) noexcept {
+  if (depth <= 0) { return perft_divide_info{}; }
+
+  perft_table table(perft_config::tt_mb_size);
+  return perft_divide(bd, depth, thread_count, table);
+}
+
+perft_suite_info get_perft_suite_info(
+    const std::string& input_path,
+    const search::depth_type& max_depth,
+    const std::size_t& thread_count,
+    std::ostream& os) noexcept {
+  std::ifstream input(input_path);
+  if (!input) { return perft_suite_info{}; }
+
+  perft_table table(perft_config::tt_mb_size);
+  perft_suite_info info{true};
+
+  simple_timer<std::chrono::nanoseconds> timer{};
+
+  for (std::string line{}; std::getline(input, line);) {
+    const std::string fen = fen_from_epd(line);
+    if (fen.empty()) { continue; }
+
+    std::istringstream fields(line.substr(std::min(line.find(';'), line.size())));
+    const chess::board bd = chess::board::parse_fen(fen);
+    bool passed{true};
+
+    for (std::string expectation{}; std::getline(fields, expectation, ';');) {
+      std::istringstream expectation_s(expectation);
+
+      std::string depth_token{};
+      std::size_t expected{};
+      if (!(expectation_s >> depth_token >> expected) || depth_token.size() < 2 || depth_token[0] != 'D') { continue; }
+
+      search::depth_type depth{};
+      if (!(std::istringstream(depth_token.substr(1)) >> depth) || depth <= 0 || depth > max_depth) { continue; }
+
+      const std::size_t count = perft_divide(bd, depth, thread_count, table).total.total_nodes;
+      info.total.total_nodes += count;
+
+      if (count != expected) {
+        passed = false;
+        os << "fail " << bd.fen() << " depth " << depth << " expected " << expected << " got " << count << std::endl;
+      }
+    }
+
+    ++info.positions;
+    ++(passed ? info.passed : info.failed);
+  }
+
+  info.total.nodes_per_second =
+      info.total.total_nodes * std::chrono::nanoseconds(std::chrono::seconds(1)).count() / std::max<std::size_t>(1, timer.elapsed().count());
+  return info;
+}
+
+}  // namespace engine
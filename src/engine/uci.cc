@@ -16,18 +16,30 @@
 */
 
 #include <chess/move.h>
+#include <engine/analysis.h>
 #include <engine/bench.h>
+#include <engine/datagen.h>
 #include <engine/option_parser.h>
+#include <engine/perft.h>
 #include <engine/processor/types.h>
 #include <engine/uci.h>
 #include <engine/version.h>
+#include <nnue/batch_eval.h>
 #include <nnue/embedded_weights.h>
+#include <nnue/simd.h>
 #include <nnue/weights_exporter.h>
 #include <nnue/weights_streamer.h>
 #include <search/search_constants.h>
 #include <search/syzygy.h>
+#include <util/large_pages.h>
+#include <util/shared_memory.h>
 
+#include <algorithm>
+#include <fstream>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace engine {
 
@@ -41,6 +53,7 @@ auto uci::options() noexcept {
     }
 
     weights_info_string();
+    if (large_pages_) { apply_large_pages(); }
   });
 
   auto weight_path = option_callback(string_option("Weights", std::string(unused_weight_path)), [this](const std::string& path) {
@@ -49,13 +62,19 @@ auto uci::options() noexcept {
     nnue::weights raw_weights{};
     raw_weights.load(path);
 
+    const bool sparse_fc0 = weights_.sparse_fc0;
     weights_ = raw_weights.to<nnue::quantized_weights>();
+    weights_.set_sparse_fc0(sparse_fc0);
+
     weights_info_string();
+    if (large_pages_) { apply_large_pages(); }
   });
 
-  auto hash_size = option_callback(spin_option("Hash", default_hash_size, spin_range{1, 262144}), [this](const int size) {
-    const auto new_size = static_cast<std::size_t>(size);
-    orchestrator_.tt_->resize(new_size);
+  auto hash_size = option_callback(spin_option("Hash", static_cast<int>(hash_size_), spin_range{1, 262144}), [this](const int size) {
+    hash_size_ = static_cast<std::size_t>(size);
+    orchestrator_.tt_->resize(hash_size_, orchestrator_.constants_->thread_count());
+    if (large_pages_) { apply_large_pages(); }
+    if (!shared_hash_name_.empty()) { apply_shared_hash(); }
   });
 
   auto thread_count = option_callback(spin_option("Threads", default_thread_count, spin_range{1, 512}), [this](const int count) {
@@ -63,10 +82,26 @@ auto uci::options() noexcept {
     orchestrator_.resize(new_count);
   });
 
+  auto multi_pv = option_callback(spin_option("MultiPV", default_multi_pv, spin_range{1, 256}), [this](const int count) {
+    const auto new_count = static_cast<std::size_t>(count);
+    orchestrator_.constants_->update_multi_pv_(new_count);
+  });
+
   auto ponder = option_callback(check_option("Ponder", default_ponder), [this](const bool& value) { ponder_.store(value); });
   auto syzygy_path = option_callback(string_option("SyzygyPath", string_option::empty), [](const std::string& path) { search::syzygy::init(path); });
+  auto sparse_fc0 = option_callback(check_option("SparseFc0", default_sparse_fc0), [this](const bool& value) { weights_.set_sparse_fc0(value); });
+
+  auto large_pages = option_callback(check_option("LargePages", default_large_pages), [this](const bool& value) {
+    large_pages_ = value;
+    apply_large_pages();
+  });
+
+  auto shared_hash = option_callback(string_option("SharedHash", string_option::empty), [this](const std::string& name) {
+    shared_hash_name_ = (name == string_option::empty) ? std::string{} : name;
+    apply_shared_hash();
+  });
 
-  return uci_options(quantized_weight_path, weight_path, hash_size, thread_count, ponder, syzygy_path);
+  return uci_options(quantized_weight_path, weight_path, hash_size, thread_count, multi_pv, ponder, syzygy_path, sparse_fc0, large_pages, shared_hash);
 }
 
 bool uci::should_quit() const noexcept { return should_quit_.load(); }
@@ -95,14 +130,47 @@ void uci::weights_info_string() noexcept {
   os << "info string loaded weights with signature 0x" << std::hex << weights_.signature() << std::dec << std::endl;
 }
 
-void uci::info_string(const search::search_worker& worker) noexcept {
+void uci::apply_large_pages() noexcept {
   std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+
+  const util::large_pages::region tt_region = orchestrator_.tt_->use_large_pages(large_pages_, orchestrator_.constants_->thread_count());
+
+  if (!large_pages_) {
+    weights_.shared.use_small_pages();
+    return;
+  }
+
+  constexpr std::size_t bytes_per_mb = 1024 * 1024;
+
+  const auto report = [this](const std::string_view& name, const util::large_pages::region& region) {
+    const std::size_t huge_page_mb = util::large_pages::huge_page_bytes(region) / bytes_per_mb;
+    const std::size_t total_mb = region.size / bytes_per_mb;
 
-  constexpr search::score_type raw_multiplier = 288;
-  constexpr search::score_type raw_divisor = 1024;
+    if (huge_page_mb == 0) {
+      os << "info string " << name << " large pages unavailable, using " << util::large_pages::small_page_size / 1024 << " KB pages" << std::endl;
+    } else {
+      os << "info string " << name << " large pages " << util::large_pages::name(region.kind) << " " << huge_page_mb << " of " << total_mb << " MB" << std::endl;
+    }
+  };
+
+  report("weights", weights_.shared.use_large_pages());
+  report("hash", tt_region);
+}
 
-  const search::score_type raw_score = worker.score();
-  const search::score_type score = raw_score * raw_multiplier / raw_divisor;
+void uci::apply_shared_hash() noexcept {
+  const util::shared_memory::segment& segment = orchestrator_.tt_->use_shared_memory(shared_hash_name_, orchestrator_.constants_->thread_count());
+  if (shared_hash_name_.empty()) { return; }
+
+  if (segment.is_valid()) {
+    os << "info string hash shared as " << segment.name << " with " << segment.attached << " attached processes" << std::endl;
+  } else {
+    os << "info string hash sharing unavailable, using a private table" << std::endl;
+  }
+}
+
+void uci::info_string(const search::search_worker& worker) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
 
   const search::depth_type depth = worker.depth();
   const std::size_t elapsed_ms = timer_.elapsed().count();
@@ -111,9 +179,20 @@ void uci::info_string(const search::search_worker& worker) noexcept {
   const std::size_t nps = std::chrono::milliseconds(std::chrono::seconds(1)).count() * nodes / (1 + elapsed_ms);
 
   const bool should_report = orchestrator_.is_searching() && depth < search::max_depth;
-  if (should_report) {
-    os << "info depth " << depth << " seldepth " << worker.internal.stack.selective_depth() << " score cp " << score << " nodes " << nodes << " nps "
-       << nps << " time " << elapsed_ms << " tbhits " << tb_hits << " pv " << worker.internal.stack.pv_string() << std::endl;
+  if (!should_report) { return; }
+
+  const std::size_t hashfull = orchestrator_.tt_->hashfull();
+
+  const auto& lines = worker.internal.lines;
+  const bool is_multi_pv = lines.size() > 1;
+
+  for (std::size_t i(0); i < lines.size(); ++i) {
+    const search::score_type score = search::to_centipawns(lines[i].score);
+    os << "info depth " << depth << " seldepth " << worker.internal.stack.selective_depth();
+    if (is_multi_pv) { os << " multipv " << (i + 1); }
+
+    os << " score cp " << score << " nodes " << nodes << " nps " << nps << " hashfull " << hashfull << " time " << elapsed_ms << " tbhits " << tb_hits << " pv "
+       << worker.internal.stack.pv_string(lines[i].pv) << std::endl;
   }
 }
 
@@ -125,12 +204,32 @@ void uci::init_time_manager(Ts&&... args) noexcept {
   manager_.init(position.turn(), T{std::forward<Ts>(args)...});
 }
 
+void uci::set_search_moves(const std::string& go_arguments) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+
+  search_moves = chess::move_list{};
+  const chess::move_list legal_moves = position.generate_moves<>();
+
+  std::istringstream argument_stream(go_arguments);
+  std::string token{};
+
+  while (argument_stream >> token && token != "searchmoves") {}
+
+  // the move list extends up to the first token which doesn't name a legal move
+  while (argument_stream >> token) {
+    const auto it = std::find_if(legal_moves.begin(), legal_moves.end(), [&](const chess::move& mv) { return mv.name(position.turn()) == token; });
+    if (it == legal_moves.end()) { break; }
+    search_moves.push(*it);
+  }
+}
+
 void uci::go() noexcept {
   std::lock_guard<std::mutex> lock(mutex_);
   if (orchestrator_.is_searching()) { return; }
 
   timer_.lap();
-  orchestrator_.go(history, position);
+  orchestrator_.go(history, position, search_moves);
 }
 
 void uci::ponder_hit() noexcept {
@@ -167,15 +266,85 @@ void uci::id_info() noexcept {
 
   os << "id name " << version::engine_name << " " << version::major << '.' << version::minor << '.' << version::patch << std::endl;
   os << "id author " << version::author_name << std::endl;
+  os << "info string using " << simd::instruction_set << " kernels" << std::endl;
   os << options();
   os << "uciok" << std::endl;
 }
 
-void uci::bench() noexcept {
+void uci::bench(const std::string& args) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+
+  const bench_options options = bench_options::parse(args);
+
+  nnue::column_density.reset();
+  const bench_report report = get_bench_report(weights_, options);
+
+  if (!report.success) {
+    os << "info string failed to read " << options.positions_path << std::endl;
+    return;
+  }
+
+  if (weights_.sparse_fc0) { os << "info string fc0 block density " << nnue::column_density.density() << std::endl; }
+
+  if (options.json) {
+    report.write_json(os);
+    os << std::endl;
+  } else {
+    os << report.total << std::endl;
+  }
+}
+
+void uci::scale_bench(const std::string& args) noexcept {
   std::lock_guard<std::mutex> lock(mutex_);
   if (orchestrator_.is_searching()) { return; }
 
-  os << get_bench_info(weights_) << std::endl;
+  // threads defaults to the machine size rather than to a single thread
+  const std::string thread_count = std::to_string(std::max(1u, std::thread::hardware_concurrency()));
+  const bench_options options = bench_options::parse("threads " + thread_count + " " + args);
+  const scale_bench_info info = get_scale_bench_info(weights_, options);
+
+  if (!info.success) {
+    os << "info string failed to read " << options.positions_path << std::endl;
+    return;
+  }
+
+  os << info << std::endl;
+}
+
+void uci::packed_board_bench() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+  os << get_packed_board_bench_info() << std::endl;
+}
+
+void uci::analyse(const std::string& input_path, const std::string& output_path, const analysis_limit& limit, const std::size_t& thread_count) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+
+  if (orchestrator_.constants_->multi_pv() > 1) { os << "info string analyse searches a single line per position, ignoring MultiPV" << std::endl; }
+  const analysis_info info = get_analysis_info(weights_, input_path, output_path, limit, thread_count);
+
+  if (!info.success) {
+    os << "info string unable to open " << input_path << " or " << output_path << std::endl;
+    return;
+  }
+
+  os << info << std::endl;
+}
+
+void uci::datagen(const std::string& output_path, const std::size_t& num_games, const std::size_t& thread_count, const std::size_t& node_limit) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+
+  const datagen_info info = get_datagen_info(weights_, output_path, num_games, thread_count, node_limit);
+
+  if (!info.success) {
+    os << "info string unable to open " << output_path << std::endl;
+    return;
+  }
+
+  os << info << std::endl;
 }
 
 void uci::export_weights(const std::string& export_path) noexcept {
@@ -200,6 +369,35 @@ void uci::eval() noexcept {
   os << "score(phase): " << score.result << std::endl;
 }
 
+void uci::eval_batch(const std::string& input_path, const std::string& output_path) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+
+  std::ifstream input(input_path);
+  if (!input) {
+    os << "info string unable to open " << input_path << std::endl;
+    return;
+  }
+
+  std::vector<chess::board> boards{};
+  for (std::string fen{}; std::getline(input, fen);) {
+    if (!fen.empty()) { boards.push_back(chess::board::parse_fen(fen)); }
+  }
+
+  simple_timer<std::chrono::milliseconds> timer{};
+  const std::vector<search::score_type> scores = nnue::batch_eval(&weights_).evaluate(boards);
+  const auto elapsed = timer.elapsed().count();
+
+  std::ofstream output(output_path);
+  if (!output) {
+    os << "info string unable to open " << output_path << std::endl;
+    return;
+  }
+
+  for (const auto& score : scores) { output << score << '\n'; }
+  os << "info string evaluated " << scores.size() << " positions in " << elapsed << " ms" << std::endl;
+}
+
 void uci::probe() noexcept {
   std::lock_guard<std::mutex> lock(mutex_);
   if (orchestrator_.is_searching()) { return; }
@@ -220,10 +418,69 @@ void uci::probe() noexcept {
   }
 }
 
+void uci::tt_stats() noexcept {
+  // permitted while searching: entries are sampled through private copies just as in find
+  std::lock_guard<std::mutex> lock(mutex_);
+  os << orchestrator_.tt_->stats();
+}
+
+void uci::save_hash(const std::string& path) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+
+  const bool saved = orchestrator_.tt_->save(path, weights_.signature());
+  os << "info string savehash " << (saved ? "wrote " : "failed to write ") << path << std::endl;
+}
+
+void uci::load_hash(const std::string& path) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+
+  // loading would overwrite the table of every process attached to the segment
+  if (orchestrator_.tt_->is_shared()) {
+    os << "info string loadhash rejected " << path << ": hash is shared as " << shared_hash_name_ << std::endl;
+    return;
+  }
+
+  const search::transposition_table_file_status status = orchestrator_.tt_->load(path, weights_.signature(), orchestrator_.constants_->thread_count());
+  if (status != search::transposition_table_file_status::ok) {
+    os << "info string loadhash rejected " << path << ": " << search::to_string(status) << std::endl;
+    return;
+  }
+
+  const std::size_t size_mb = orchestrator_.tt_->size() / search::transposition_table::one_mb;
+  os << "info string loadhash read " << path << " (" << size_mb << " MB)" << std::endl;
+
+  if (size_mb != hash_size_) {
+    hash_size_ = size_mb;
+    os << "info string Hash set to " << hash_size_ << " MB" << std::endl;
+  }
+}
+
 void uci::perft(const search::depth_type& depth) noexcept {
   std::lock_guard<std::mutex> lock(mutex_);
   if (orchestrator_.is_searching()) { return; }
-  std::cout << get_perft_info(position, depth) << std::endl;
+  std::cout << get_perft_info(position, depth, orchestrator_.constants_->thread_count()) << std::endl;
+}
+
+void uci::perft_divide(const search::depth_type& depth) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+  std::cout << get_perft_divide_info(position, depth, orchestrator_.constants_->thread_count()) << std::endl;
+}
+
+void uci::perft_suite(const std::string& input_path, const search::depth_type& max_depth) noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (orchestrator_.is_searching()) { return; }
+
+  const perft_suite_info info = get_perft_suite_info(input_path, max_depth, orchestrator_.constants_->thread_count(), std::cout);
+
+  if (!info.success) {
+    std::cout << "info string failed to read " << input_path << std::endl;
+    return;
+  }
+
+  std::cout << info << std::endl;
 }
 
 void uci::read(const std::string& line) noexcept {
@@ -257,6 +514,7 @@ void uci::read(const std::string& line) noexcept {
     )),
 
     sequential(consume("go"), parallel(
+      sequential(emit_all, invoke([&] (const std::string& go_arguments) { set_search_moves(go_arguments); })),
       sequential(consume("infinite"), invoke([&] { init_time_manager<go::infinite>(); })),      
       sequential(consume("nodes"), emit<std::size_t>, invoke([&] (const std::size_t& nodes) { init_time_manager<go::nodes>(nodes); })),
       sequential(consume("depth"), emit<search::depth_type>, invoke([&] (const search::depth_type& depth) { init_time_manager<go::depth>(depth); })),
@@ -280,10 +538,36 @@ void uci::read(const std::string& line) noexcept {
 
     // extensions
     sequential(consume("export"), emit<std::string>, invoke([&] (const std::string& export_path) { export_weights(export_path); })),
-    sequential(consume("perft"), emit<search::depth_type>, invoke([&] (const search::depth_type& depth) { perft(depth); })),
-    sequential(consume("bench"), invoke([&] { bench(); })),
+    sequential(consume("perft"), condition("divide"), parallel(
+      sequential(key<search::depth_type>("divide"), invoke([&] (const bool&, const search::depth_type& depth) { perft_divide(depth); })),
+      sequential(emit<search::depth_type>, invoke([&] (const bool& divide, const search::depth_type& depth) { if (!divide) { perft(depth); } }))
+    )),
+    sequential(consume("perftsuite"), emit<std::string>, emit<search::depth_type>, invoke([&] (const std::string& input_path, const search::depth_type& max_depth) {
+      perft_suite(input_path, max_depth);
+    })),
+    sequential(consume("bench"), emit_all, invoke([&] (const std::string& args) { bench(args); })),
+    sequential(consume("scalebench"), emit_all, invoke([&] (const std::string& args) { scale_bench(args); })),
+    sequential(consume("packbench"), invoke([&] { packed_board_bench(); })),
+    sequential(consume("analyse"), emit<std::string>, emit<std::string>, parallel(
+      sequential(consume("depth"), emit<std::size_t>, consume("threads"), emit<std::size_t>, invoke([&] (const auto& in, const auto& out, const std::size_t& depth, const std::size_t& threads) {
+        analyse(in, out, analysis_limit{analysis_limit_type::depth, std::min(depth, static_cast<std::size_t>(search::max_depth))}, threads);
+      })),
+      sequential(consume("nodes"), emit<std::size_t>, consume("threads"), emit<std::size_t>, invoke([&] (const auto& in, const auto& out, const std::size_t& nodes, const std::size_t& threads) {
+        analyse(in, out, analysis_limit{analysis_limit_type::nodes, nodes}, threads);
+      }))
+    )),
+    sequential(consume("datagen"), emit<std::string>, consume("games"), emit<std::size_t>, consume("threads"), emit<std::size_t>, consume("nodes"), emit<std::size_t>,
+      invoke([&] (const std::string& output_path, const std::size_t& games, const std::size_t& threads, const std::size_t& nodes) {
+        datagen(output_path, games, threads, nodes);
+      })),
     sequential(consume("probe"), invoke([&] { probe(); })),
-    sequential(consume("eval"), invoke([&] { eval(); }))
+    sequential(consume("eval"), invoke([&] { eval(); })),
+    sequential(consume("ttstats"), invoke([&] { tt_stats(); })),
+    sequential(consume("savehash"), emit<std::string>, invoke([&] (const std::string& path) { save_hash(path); })),
+    sequential(consume("loadhash"), emit<std::string>, invoke([&] (const std::string& path) { load_hash(path); })),
+    sequential(consume("evalbatch"), emit<std::string>, emit<std::string>, invoke([&] (const std::string& input_path, const std::string& output_path) {
+      eval_batch(input_path, output_path);
+    }))
   );
 
   // clang-format on
@@ -0,0 +1,286 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <chess/board.h>
+#include <chess/move_list.h>
+#include <engine/bench.h>
+#include <nnue/embedded_weights.h>
+#include <nnue/eval.h>
+#include <nnue/feature_reset_cache.h>
+#include <nnue/weights.h>
+#include <nnue/weights_streamer.h>
+#include <search/history_heuristic.h>
+#include <search/move_orderer.h>
+#include <search/transposition_table.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// self contained timing harness for the primitives the search is built from. every benchmark makes
+// num_samples timed passes over the bench positions and their children (after one untimed warm up
+// pass) and reports the mean, standard deviation and minimum cost per operation across passes.
+namespace microbench {
+
+constexpr std::size_t num_samples = 16;
+constexpr std::size_t tt_mb_size = 16;
+
+using clock_type = std::chrono::steady_clock;
+
+struct sample {
+  std::chrono::nanoseconds elapsed{};
+  std::size_t ops{0};
+};
+
+struct result {
+  std::string name{};
+  std::size_t ops{0};
+  double mean_ns{0.0};
+  double stddev_ns{0.0};
+  double min_ns{0.0};
+};
+
+template <typename T>
+inline void do_not_optimize(const T& value) noexcept {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+template <typename F>
+[[nodiscard]] sample timed(F&& f) noexcept {
+  const auto start = clock_type::now();
+  const std::size_t ops = f();
+  return sample{std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start), ops};
+}
+
+template <typename F>
+[[nodiscard]] result measure(const std::string& name, F&& pass) noexcept {
+  static_cast<void>(pass());
+
+  std::vector<double> ns_per_op{};
+  std::size_t ops{};
+
+  for (std::size_t i(0); i < num_samples; ++i) {
+    const sample s = pass();
+    ops = s.ops;
+    ns_per_op.push_back(static_cast<double>(s.elapsed.count()) / static_cast<double>(std::max(s.ops, std::size_t{1})));
+  }
+
+  const double mean = std::accumulate(ns_per_op.begin(), ns_per_op.end(), 0.0) / static_cast<double>(ns_per_op.size());
+  const double variance = std::accumulate(ns_per_op.begin(), ns_per_op.end(), 0.0, [mean](const double& acc, const double& x) {
+    return acc + (x - mean) * (x - mean);
+  }) / static_cast<double>(ns_per_op.size());
+
+  return result{name, ops, mean, std::sqrt(variance), *std::min_element(ns_per_op.begin(), ns_per_op.end())};
+}
+
+std::ostream& operator<<(std::ostream& os, const result& r) noexcept {
+  return os << std::left << std::setw(32) << r.name << std::right << std::setw(10) << r.ops << std::fixed << std::setprecision(2) << std::setw(12) << r.mean_ns
+            << std::setw(12) << r.stddev_ns << std::setw(12) << r.min_ns << std::defaultfloat;
+}
+
+}  // namespace microbench
+
+int main() {
+  using namespace microbench;
+
+  auto weights = std::make_unique<nnue::quantized_weights>();
+  nnue::embedded_weight_streamer embedded(nnue::embed::weights_file_data);
+  weights->load(embedded);
+
+  std::vector<chess::board> boards{};
+  for (const auto& fen : engine::bench_config::fens) {
+    const chess::board bd = chess::board::parse_fen(std::string(fen));
+    boards.push_back(bd);
+    for (const auto& mv : bd.generate_moves<>()) { boards.push_back(bd.forward(mv)); }
+  }
+
+  std::vector<chess::move_list> moves{};
+  std::size_t num_moves{};
+  for (const auto& bd : boards) {
+    moves.push_back(bd.generate_moves<>());
+    num_moves += moves.back().size();
+  }
+
+  auto scratchpad = std::make_unique<nnue::eval::scratchpad_type>();
+  auto reset_cache = std::make_unique<nnue::sided_feature_reset_cache>();
+  reset_cache->reinitialize(weights.get());
+
+  auto tt = std::make_unique<search::transposition_table>(tt_mb_size);
+  auto hh = std::make_unique<search::sided_history_heuristic>();
+  auto stepper = std::make_unique<search::move_orderer_stepper>();
+
+  std::vector<result> results{};
+
+  results.push_back(measure("generate_moves<all>", [&] {
+    return timed([&] {
+      for (const auto& bd : boards) { do_not_optimize(bd.generate_moves<chess::generation_mode::all>()); }
+      return boards.size();
+    });
+  }));
+
+  results.push_back(measure("generate_moves<noisy_and_check>", [&] {
+    return timed([&] {
+      for (const auto& bd : boards) { do_not_optimize(bd.generate_moves<chess::generation_mode::noisy_and_check>()); }
+      return boards.size();
+    });
+  }));
+
+  results.push_back(measure("forward", [&] {
+    return timed([&] {
+      for (std::size_t i(0); i < boards.size(); ++i) {
+        for (const auto& mv : moves[i]) { do_not_optimize(boards[i].forward(mv)); }
+      }
+      return num_moves;
+    });
+  }));
+
+  results.push_back(measure("see_ge", [&] {
+    return timed([&] {
+      for (std::size_t i(0); i < boards.size(); ++i) {
+        for (const auto& mv : moves[i]) { do_not_optimize(boards[i].see_ge(mv, std::int32_t{0})); }
+      }
+      return num_moves;
+    });
+  }));
+
+  // moves of the neighbouring position stand in for (mostly illegal) transposition table moves
+  results.push_back(measure("is_legal<all>", [&] {
+    return timed([&] {
+      std::size_t ops{};
+      for (std::size_t i(0); i < boards.size(); ++i) {
+        const chess::move_list& candidates = moves[(i + 1) % boards.size()];
+        for (const auto& mv : candidates) { do_not_optimize(boards[i].is_legal<chess::generation_mode::all>(mv)); }
+        ops += candidates.size();
+      }
+      return ops;
+    });
+  }));
+
+  results.push_back(measure("feature_full_reset", [&] {
+    return timed([&] {
+      for (const auto& bd : boards) {
+        nnue::eval accumulator(weights.get(), scratchpad.get(), 0, 0);
+        bd.feature_full_reset(accumulator);
+        do_not_optimize(accumulator);
+      }
+      return boards.size();
+    });
+  }));
+
+  // parents are reset untimed in pairs of scratchpad slots, so only the deltas into the child slots are timed
+  results.push_back(measure("feature_move_delta", [&] {
+    constexpr std::size_t chunk_size = nnue::eval::scratchpad_depth / 2;
+    sample total{};
+
+    for (std::size_t offset(0); offset < boards.size(); offset += chunk_size) {
+      const std::size_t size = std::min(chunk_size, boards.size() - offset);
+
+      for (std::size_t k(0); k < size; ++k) {
+        nnue::eval parent(weights.get(), scratchpad.get(), 2 * k, 2 * k);
+        boards[offset + k].feature_full_reset(parent);
+      }
+
+      const sample s = timed([&] {
+        std::size_t ops{};
+        for (std::size_t k(0); k < size; ++k) {
+          for (const auto& mv : moves[offset + k]) {
+            nnue::eval child(weights.get(), scratchpad.get(), 2 * k, 2 * k + 1);
+            boards[offset + k].feature_move_delta(mv, *reset_cache, child);
+            do_not_optimize(child);
+          }
+          ops += moves[offset + k].size();
+        }
+        return ops;
+      });
+
+      total.elapsed += s.elapsed;
+      total.ops += s.ops;
+    }
+
+    return total;
+  }));
+
+  results.push_back(measure("eval::evaluate", [&] {
+    constexpr std::size_t chunk_size = nnue::eval::scratchpad_depth;
+    sample total{};
+
+    for (std::size_t offset(0); offset < boards.size(); offset += chunk_size) {
+      const std::size_t size = std::min(chunk_size, boards.size() - offset);
+
+      for (std::size_t k(0); k < size; ++k) {
+        nnue::eval accumulator(weights.get(), scratchpad.get(), k, k);
+        boards[offset + k].feature_full_reset(accumulator);
+      }
+
+      const sample s = timed([&] {
+        for (std::size_t k(0); k < size; ++k) {
+          const chess::board& bd = boards[offset + k];
+          const nnue::eval accumulator(weights.get(), scratchpad.get(), k, k);
+          do_not_optimize(accumulator.evaluate(bd.turn(), bd.phase<nnue::weights::parameter_type>()).result);
+        }
+        return size;
+      });
+
+      total.elapsed += s.elapsed;
+      total.ops += s.ops;
+    }
+
+    return total;
+  }));
+
+  results.push_back(measure("transposition_table::insert", [&] {
+    return timed([&] {
+      for (std::size_t i(0); i < boards.size(); ++i) {
+        const chess::move mv = moves[i].size() != 0 ? moves[i][0] : chess::move::null();
+        tt->insert(boards[i].hash(), search::transposition_table_entry(boards[i].hash(), search::eval_data_packet{}, search::bound_type::exact, 0, mv, 1));
+      }
+      return boards.size();
+    });
+  }));
+
+  results.push_back(measure("transposition_table::find", [&] {
+    return timed([&] {
+      for (const auto& bd : boards) { do_not_optimize(tt->find(bd.hash())); }
+      return boards.size();
+    });
+  }));
+
+  results.push_back(measure("move_orderer initialize", [&] {
+    return timed([&] {
+      for (std::size_t i(0); i < boards.size(); ++i) {
+        stepper->initialize(search::move_orderer_data(&boards[i], &hh->us(boards[i].turn())), moves[i]);
+        do_not_optimize(*stepper);
+      }
+      return boards.size();
+    });
+  }));
+
+  std::cout << boards.size() << " positions " << num_moves << " moves " << num_samples << " samples\n";
+  std::cout << std::left << std::setw(32) << "benchmark" << std::right << std::setw(10) << "ops" << std::setw(12) << "ns/op" << std::setw(12) << "stddev"
+            << std::setw(12) << "min" << '\n';
+  for (const auto& r : results) { std::cout << r << '\n'; }
+
+  return 0;
+}
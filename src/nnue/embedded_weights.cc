@@ -0,0 +1,54 @@
+/*
+  Seer is a UCI chess engine by Connor McMonigle
+  Copyright (C) 2021-2023  Connor McMonigle
+
+  Seer is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Seer is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <nnue/embedded_weights.h>
+
+namespace nnue::embed {
+
+#if defined(__ELF__)
+// equivalent to INCBIN(weights_file, EVALFILE), except that the blob is placed four bytes
+// (the size of the signature) short of a 64 byte boundary. this aligns the feature
+// transformer weights which immediately follow the signature, so that they can be used
+// in place directly from the read only mapping of the executable.
+__asm__(
+    ".pushsection .rodata\n"
+    ".global weights_file_data\n"
+    ".type weights_file_data, @object\n"
+    ".balign 64\n"
+    ".skip 60\n"
+    "weights_file_data:\n"
+    ".incbin \"" EVALFILE
+    "\"\n"
+    ".global weights_file_end\n"
+    ".type weights_file_end, @object\n"
+    ".balign 1\n"
+    "weights_file_end:\n"
+    ".byte 1\n"
+    ".global weights_file_size\n"
+    ".type weights_file_size, @object\n"
+    ".balign 64\n"
+    "weights_file_size:\n"
+    ".int weights_file_end - weights_file_data\n"
+    ".balign 64\n"
+    ".popsection\n");
+#else
+extern "C" {
+INCBIN(weights_file, EVALFILE);
+}
+#endif
+
+}  // namespace nnue::embed
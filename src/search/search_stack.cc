@@ -21,11 +21,11 @@
 
 namespace search {
 
-std::string search_stack::pv_string() const noexcept {
+std::string search_stack::pv_string(const std::array<chess::move, safe_depth>& pv) const noexcept {
   auto bd = present_;
   std::string result{};
 
-  for (const auto& pv_mv : future_.begin()->pv_) {
+  for (const auto& pv_mv : pv) {
     if (!bd.generate_moves<>().has(pv_mv)) { break; }
     result += pv_mv.name(bd.turn()) + " ";
     bd = bd.forward(pv_mv);
@@ -33,6 +33,8 @@ std::string search_stack::pv_string() const noexcept {
   return result;
 }
 
+std::string search_stack::pv_string() const noexcept { return pv_string(future_.begin()->pv_); }
+
 chess::move search_stack::ponder_move() const noexcept { return *(future_.begin()->pv_.begin() + 1); }
 
 search_stack& search_stack::clear_future() noexcept {
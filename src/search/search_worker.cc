@@ -200,7 +200,8 @@ pv_search_result_t<is_root> search_worker::pv_search(
   }
 
   if constexpr (is_root) {
-    if (const syzygy::tb_dtz_result result = syzygy::probe_dtz(bd); result.success) { return make_result(result.score, result.move); }
+    const bool try_dtz = !internal.has_skipped_root_moves();
+    if (const syzygy::tb_dtz_result result = syzygy::probe_dtz(bd); try_dtz && result.success) { return make_result(result.score, result.move); }
   }
 
   const std::optional<transposition_table_entry> maybe = !ss.has_excluded() ? external.tt->find(bd.hash()) : std::nullopt;
@@ -326,10 +327,17 @@ pv_search_result_t<is_root> search_worker::pv_search(
 
   int legal_count{0};
 
-  for (const auto& [idx, mv] : orderer) {
+  // skipped root moves (MultiPV lines already searched and moves outside "go searchmoves") don't count
+  // towards the move index, so that the first move searched at the root gets the full window and isn't reduced
+  int root_searched_count{0};
+
+  for (const auto& [orderer_idx, mv] : orderer) {
     ++legal_count;
     if (!internal.keep_going()) { break; }
     if (mv == ss.excluded()) { continue; }
+    if (is_root && internal.is_skipped_root_move(mv)) { continue; }
+
+    const int idx = is_root ? root_searched_count++ : orderer_idx;
 
     const std::size_t nodes_before = internal.nodes.load(std::memory_order_relaxed);
     const counter_type history_value = internal.hh.us(bd.turn()).compute_value(history::context{follow, counter, threatened, pawn_hash}, mv);
@@ -462,7 +470,8 @@ pv_search_result_t<is_root> search_worker::pv_search(
   if (legal_count == 0) { return make_result(draw_score, chess::move::null()); }
 
   // step 14. update histories if appropriate and maybe insert a new transposition_table_entry
-  if (internal.keep_going() && !ss.has_excluded()) {
+  const bool has_skipped_root_moves = is_root && internal.has_skipped_root_moves();
+  if (internal.keep_going() && !ss.has_excluded() && !has_skipped_root_moves) {
     const bound_type bound = [&] {
       if (best_score >= beta) { return bound_type::lower; }
       if (is_pv && best_score > original_alpha) { return bound_type::exact; }
@@ -494,49 +503,81 @@ void search_worker::iterative_deepening_loop() noexcept {
     return result;
   }());
 
-  score_type alpha = -big_number;
-  score_type beta = big_number;
   for (; internal.keep_going(); ++internal.depth) {
     internal.depth = std::min(max_depth, internal.depth.load());
-    // update aspiration window once reasonable evaluation is obtained
-    if (internal.depth >= external.constants->aspiration_depth()) {
-      const score_type previous_score = internal.score;
-      alpha = previous_score - aspiration_delta;
-      beta = previous_score + aspiration_delta;
-    }
 
-    score_type delta = aspiration_delta;
-    depth_type consecutive_failed_high_count{0};
+    // lines after the first are searched with the first moves of the preceding lines excluded at the root
+    for (internal.line_idx = 0; internal.keep_going() && internal.line_idx < internal.lines.size(); ++internal.line_idx) {
+      pv_line& line = internal.lines[internal.line_idx];
 
-    for (;;) {
-      internal.stack.clear_future();
+      score_type alpha = -big_number;
+      score_type beta = big_number;
 
-      const depth_type adjusted_depth = std::max(1, internal.depth - consecutive_failed_high_count);
-      const auto [search_score, search_move] = pv_search<true, true>(
-          stack_view::root(internal.stack), root_node, internal.stack.root(), alpha, beta, adjusted_depth, chess::player_type::none);
+      // update aspiration window once reasonable evaluation is obtained. a line can't be expected to
+      // score above the line preceding it, so its window is capped by that line's score.
+      if (internal.depth >= external.constants->aspiration_depth()) {
+        const score_type previous_score = line.score;
+        alpha = previous_score - aspiration_delta;
+        beta = previous_score + aspiration_delta;
 
-      if (!internal.keep_going()) { break; }
+        if (internal.line_idx != 0) {
+          beta = std::min(beta, internal.lines[internal.line_idx - 1].score + 1);
+          alpha = std::min(alpha, beta - aspiration_delta);
+        }
+      }
 
-      // update aspiration window if failing low or high
-      if (search_score <= alpha) {
-        beta = (alpha + beta) / 2;
-        alpha = search_score - delta;
-        consecutive_failed_high_count = 0;
-      } else if (search_score >= beta) {
-        beta = search_score + delta;
-        ++consecutive_failed_high_count;
-      } else {
-        // store updated information
-        internal.score.store(search_score);
-        if (!search_move.is_null()) {
-          internal.best_move.store(search_move.data);
-          internal.ponder_move.store(internal.stack.ponder_move().data);
+      score_type delta = aspiration_delta;
+      depth_type consecutive_failed_high_count{0};
+
+      for (;;) {
+        internal.stack.clear_future();
+
+        const depth_type adjusted_depth = std::max(1, internal.depth - consecutive_failed_high_count);
+        const auto [search_score, search_move] = pv_search<true, true>(
+            stack_view::root(internal.stack), root_node, internal.stack.root(), alpha, beta, adjusted_depth, chess::player_type::none);
+
+        if (!internal.keep_going()) { break; }
+
+        // update aspiration window if failing low or high
+        if (search_score <= alpha) {
+          beta = (alpha + beta) / 2;
+          alpha = search_score - delta;
+          consecutive_failed_high_count = 0;
+        } else if (search_score >= beta) {
+          beta = search_score + delta;
+          ++consecutive_failed_high_count;
+        } else {
+          // store updated information
+          line.score = search_score;
+          if (!search_move.is_null()) { line.pv = internal.stack.at(0).pv_; }
+
+          if (internal.line_idx == 0) {
+            internal.score.store(search_score);
+            if (!search_move.is_null()) {
+              internal.best_move.store(search_move.data);
+              internal.ponder_move.store(internal.stack.ponder_move().data);
+            }
+          }
+          break;
         }
-        break;
+
+        // exponentially grow window
+        delta += delta / 3;
       }
+    }
 
-      // exponentially grow window
-      delta += delta / 3;
+    // a line's window is only capped by the preceding line until it fails high, so a line may settle above
+    // the lines before it. once the iteration completes, every line is ordered by score and the best move
+    // (which the time manager's stability tracking follows) is taken from the top line.
+    if (internal.keep_going()) {
+      std::stable_sort(internal.lines.begin(), internal.lines.end(), [](const pv_line& a, const pv_line& b) { return a.score > b.score; });
+
+      const pv_line& best_line = internal.lines.front();
+      internal.score.store(best_line.score);
+      if (!best_line.move().is_null()) {
+        internal.best_move.store(best_line.move().data);
+        internal.ponder_move.store(best_line.pv[1].data);
+      }
     }
 
     // callback on iteration completion
@@ -23,7 +23,7 @@
 namespace search {
 
 void worker_orchestrator::reset() noexcept {
-  tt_->clear();
+  if (!tt_->is_shared()) { tt_->clear(constants_->thread_count()); }
   for (auto& worker_thread : worker_threads_) { worker_thread->worker().internal.reset(); };
 }
 
@@ -39,13 +39,23 @@ void worker_orchestrator::resize(const std::size_t& new_size) noexcept {
   }
 }
 
-void worker_orchestrator::go(const chess::board_history& hist, const chess::board& bd) noexcept {
+void worker_orchestrator::parallel_for(const std::size_t& count, const std::function<void(const std::size_t&)>& fn) noexcept {
+  const std::size_t num_dispatched = std::min(count, worker_threads_.size());
+  for (std::size_t i(0); i < num_dispatched; ++i) {
+    worker_threads_[i]->run([&fn, i] { fn(i); });
+  }
+
+  for (std::size_t i(num_dispatched); i < count; ++i) { fn(i); }
+  for (std::size_t i(0); i < num_dispatched; ++i) { worker_threads_[i]->wait(); }
+}
+
+void worker_orchestrator::go(const chess::board_history& hist, const chess::board& bd, const chess::move_list& root_moves) noexcept {
   std::lock_guard access_lock(access_mutex_);
 
   tt_->update_gen();
   for (std::size_t i(0); i < worker_threads_.size(); ++i) {
     const depth_type start_depth = 1 + static_cast<depth_type>(i % 2);
-    worker_threads_[i]->go(hist, bd, start_depth);
+    worker_threads_[i]->go(hist, bd, start_depth, root_moves);
   }
 
   is_searching_.store(true);
@@ -57,6 +67,10 @@ void worker_orchestrator::stop() noexcept {
   is_searching_.store(false);
 }
 
+void worker_orchestrator::wait() noexcept {
+  std::for_each(worker_threads_.begin(), worker_threads_.end(), [](auto& worker_thread) { worker_thread->wait(); });
+}
+
 bool worker_orchestrator::is_searching() noexcept {
   std::lock_guard access_lock(access_mutex_);
   return is_searching_.load();
@@ -87,6 +101,11 @@ worker_orchestrator::worker_orchestrator(
   
   const search_worker_external_state external_state{weights, tt_, constants_, on_iter, on_update};
   worker_threads_.push_back(std::make_unique<search_worker_thread>(external_state));
+
+  tt_->parallel_for_ = [this](const std::size_t& count, const std::function<void(const std::size_t&)>& fn) { parallel_for(count, fn); };
 }
 
+// the table may outlive the orchestrator through the external state it shares with other owners
+worker_orchestrator::~worker_orchestrator() noexcept { tt_->parallel_for_ = nullptr; }
+
 }  // namespace search
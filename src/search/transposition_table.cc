@@ -15,23 +15,188 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <nnue/mapped_file.h>
 #include <search/transposition_table.h>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
 namespace search {
 
-void transposition_table::clear() noexcept {
-  for (auto& elem : data) { elem = bucket_type{}; }
+void transposition_table::allocate_(const std::size_t& size) noexcept {
+  size_ = size;
+  const std::size_t bytes = size_ * sizeof(bucket_type);
+
+  if (!shared_name_.empty()) {
+    shared_ = util::shared_memory::attach(shared_name_, cache_line_size + bytes);
+    if (shared_.is_valid()) {
+      auto* payload = static_cast<unsigned char*>(shared_.payload());
+      current_gen_ = reinterpret_cast<std::atomic<gen_type>*>(payload);
+      data_ = reinterpret_cast<bucket_type*>(payload + cache_line_size);
+      return;
+    }
+  }
+
+  if (use_large_pages_) {
+    region_ = util::large_pages::allocate(bytes, true);
+    if (region_.is_valid()) {
+      data_ = static_cast<bucket_type*>(region_.data);
+      return;
+    }
+  }
+
+#if defined(__linux__)
+  void* small_region = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (small_region != MAP_FAILED) {
+    region_ = util::large_pages::region{small_region, bytes, util::large_pages::page_kind::small};
+    data_ = static_cast<bucket_type*>(small_region);
+    return;
+  }
+#endif
+
+  region_ = util::large_pages::region{};
+  data_ = new bucket_type[size_];
+}
+
+void transposition_table::deallocate_() noexcept {
+  if (data_ == nullptr) { return; }
+
+  if (shared_.is_valid()) {
+    util::shared_memory::detach(shared_);
+    shared_ = util::shared_memory::segment{};
+    current_gen_ = &local_gen_;
+  } else if (region_.is_valid()) {
+    util::large_pages::deallocate(region_);
+  } else {
+    delete[] data_;
+  }
+
+  data_ = nullptr;
+  size_ = 0;
+  region_ = util::large_pages::region{};
+}
+
+template <typename F>
+void transposition_table::for_each_slice_(const std::size_t& thread_count, F&& fn) noexcept {
+  const std::size_t num_threads = std::clamp(thread_count, std::size_t{1}, std::max(size_, std::size_t{1}));
+  const std::size_t slice_size = (size_ + num_threads - 1) / num_threads;
+
+  const std::function<void(const std::size_t&)> run_slice = [this, slice_size, &fn](const std::size_t& idx) {
+    const std::size_t begin = std::min(size_, idx * slice_size);
+    const std::size_t end = std::min(size_, begin + slice_size);
+    fn(begin, end);
+  };
+
+  if (parallel_for_) {
+    parallel_for_(num_threads, run_slice);
+    return;
+  }
+
+  std::vector<std::thread> threads{};
+  for (std::size_t i(1); i < num_threads; ++i) { threads.emplace_back(run_slice, i); }
+
+  run_slice(0);
+  for (auto& thread : threads) { thread.join(); }
+}
+
+void transposition_table::clear(const std::size_t& thread_count) noexcept {
+  for_each_slice_(thread_count, [this](const std::size_t& begin, const std::size_t& end) { std::fill(data_ + begin, data_ + end, bucket_type{}); });
+}
+
+void transposition_table::resize(const std::size_t& size, const std::size_t& thread_count) noexcept {
+  deallocate_();
+  allocate_(size * one_mb);
+  if (!is_shared()) { clear(thread_count); }
+}
+
+util::large_pages::region transposition_table::use_large_pages(const bool& value, const std::size_t& thread_count) noexcept {
+  if (value != use_large_pages_) {
+    use_large_pages_ = value;
+    resize(size_ / one_mb, thread_count);
+  }
+
+  return region_;
+}
+
+std::string_view to_string(const transposition_table_file_status& status) noexcept {
+  switch (status) {
+    case transposition_table_file_status::ok: return "ok";
+    case transposition_table_file_status::unreadable: return "unreadable";
+    case transposition_table_file_status::bad_header: return "bad header";
+    case transposition_table_file_status::layout_mismatch: return "entry layout mismatch";
+    case transposition_table_file_status::signature_mismatch: return "network signature mismatch";
+    case transposition_table_file_status::size_mismatch: return "size mismatch";
+    default: return "unknown";
+  }
+}
+
+bool transposition_table::save(const std::string& path, const std::uint32_t& signature) const noexcept {
+  transposition_table_file_header header{};
+  header.entry_size = sizeof(transposition_table_entry);
+  header.per_bucket = per_bucket;
+  header.signature = signature;
+  header.size = size_;
+  header.current_gen = current_gen().load(std::memory_order_relaxed);
+
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(data_), static_cast<std::streamsize>(size_ * sizeof(bucket_type)));
+  return static_cast<bool>(file.flush());
 }
 
-void transposition_table::resize(const std::size_t& size) noexcept {
-  clear();
-  data.resize(size * one_mb, bucket_type{});
+transposition_table_file_status transposition_table::load(const std::string& path, const std::uint32_t& signature, const std::size_t& thread_count) noexcept {
+  const nnue::mapped_file file(path);
+  if (!file.is_open()) { return transposition_table_file_status::unreadable; }
+  if (file.size() < sizeof(transposition_table_file_header)) { return transposition_table_file_status::bad_header; }
+
+  transposition_table_file_header header{};
+  std::memcpy(&header, file.data(), sizeof(header));
+
+  if (header.magic != transposition_table_file_header::expected_magic) { return transposition_table_file_status::bad_header; }
+
+  const bool layout_matches = header.layout_version == transposition_table_file_header::expected_layout_version &&
+                              header.entry_size == sizeof(transposition_table_entry) && header.per_bucket == per_bucket;
+  if (!layout_matches) { return transposition_table_file_status::layout_mismatch; }
+  if (header.signature != signature) { return transposition_table_file_status::signature_mismatch; }
+
+  const bool size_matches = header.size != 0 && header.size % one_mb == 0 && file.size() == sizeof(header) + header.size * sizeof(bucket_type);
+  if (!size_matches) { return transposition_table_file_status::size_mismatch; }
+
+  if (header.size != size_) {
+    deallocate_();
+    allocate_(header.size);
+  }
+
+  // each thread faults in (and hence places) the pages of the slice it copies, just as in clear
+  const auto* buckets = reinterpret_cast<const bucket_type*>(file.data() + sizeof(header));
+  for_each_slice_(thread_count, [this, buckets](const std::size_t& begin, const std::size_t& end) { std::copy(buckets + begin, buckets + end, data_ + begin); });
+
+  current_gen() = static_cast<gen_type>(header.current_gen);
+  return transposition_table_file_status::ok;
+}
+
+const util::shared_memory::segment& transposition_table::use_shared_memory(const std::string& name, const std::size_t& thread_count) noexcept {
+  if (name != shared_name_) {
+    shared_name_ = name;
+    resize(size_ / one_mb, thread_count);
+  }
+
+  return shared_;
 }
 
 void transposition_table::update_gen() noexcept {
-  using gen_type = transposition_table_entry::gen_type;
   constexpr gen_type limit = gen_type{1} << transposition_table_entry::gen_bits;
-  current_gen = (current_gen + 1) % limit;
+
+  // other processes attached to a shared table may age it concurrently
+  gen_type expected = current_gen().load(std::memory_order_relaxed);
+  while (!current_gen().compare_exchange_weak(expected, static_cast<gen_type>((expected + 1) % limit), std::memory_order_relaxed)) {}
 }
 
 // clang-format off
@@ -39,13 +204,14 @@ void transposition_table::update_gen() noexcept {
 __attribute__((no_sanitize("thread")))
 transposition_table& transposition_table::insert(const zobrist::hash_type& key, const transposition_table_entry& entry) noexcept {
   constexpr depth_type offset = 2;
-  const transposition_table_entry::gen_type gen = current_gen.load(std::memory_order_relaxed);
-  transposition_table_entry* to_replace = data[hash_function(key)].to_replace(gen, key);
+  const transposition_table_entry::gen_type gen = current_gen().load(std::memory_order_relaxed);
+  transposition_table_entry* to_replace = data_[hash_function(key)].to_replace(gen, key);
+  const transposition_table_entry existing = *to_replace;
 
   const bool should_replace =
-      (entry.bound() == bound_type::exact) || (!to_replace->key_matches(key)) || ((entry.depth() + offset) >= to_replace->depth());
+      (entry.bound() == bound_type::exact) || (!existing.key_matches(key)) || ((entry.depth() + offset) >= existing.depth());
 
-  if (should_replace) { *to_replace = transposition_table_entry(entry).set_gen(gen).merge(*to_replace); }
+  if (should_replace) { *to_replace = transposition_table_entry(entry).set_gen(gen).merge(existing); }
 
   return *this;
 }
@@ -56,10 +222,63 @@ transposition_table& transposition_table::insert(const zobrist::hash_type& key,
 
 __attribute__((no_sanitize("thread")))
 std::optional<transposition_table_entry> transposition_table::find(const zobrist::hash_type& key) noexcept {
-  const transposition_table_entry::gen_type gen = current_gen.load(std::memory_order_relaxed);
-  return data[hash_function(key)].match(gen, key);
+  const transposition_table_entry::gen_type gen = current_gen().load(std::memory_order_relaxed);
+  return data_[hash_function(key)].match(gen, key);
+}
+
+// clang-format on
+
+// clang-format off
+
+__attribute__((no_sanitize("thread")))
+transposition_table_stats transposition_table::stats(const std::size_t& sample_buckets) const noexcept {
+  const transposition_table_entry::gen_type gen = current_gen().load(std::memory_order_relaxed);
+  transposition_table_stats result{};
+
+  const std::size_t buckets = std::min(sample_buckets, size_);
+  for (std::size_t i(0); i < buckets; ++i) {
+    for (const auto& elem : data_[i].data) {
+      const transposition_table_entry entry = elem;
+      ++result.sampled;
+      if (entry.is_empty()) { continue; }
+
+      ++result.occupied;
+      if (entry.is_current(gen)) { ++result.current; }
+
+      if (!entry.search_present()) {
+        ++result.eval_only;
+        continue;
+      }
+
+      ++result.search_present;
+      ++result.bounds[static_cast<std::size_t>(entry.bound())];
+      ++result.depths[std::clamp(entry.depth(), depth_type{0}, max_depth)];
+    }
+  }
+
+  return result;
 }
 
 // clang-format on
 
+std::ostream& operator<<(std::ostream& os, const transposition_table_stats& stats) noexcept {
+  constexpr std::size_t per_mille = 1000;
+  const auto ratio = [](const std::size_t& num, const std::size_t& den) { return den == 0 ? 0 : per_mille * num / den; };
+
+  os << "info string tt sampled " << stats.sampled << " hashfull " << stats.hashfull() << " occupied " << ratio(stats.occupied, stats.sampled)
+     << " permille" << std::endl;
+  os << "info string tt search " << stats.search_present << " eval_only " << stats.eval_only << " stale " << (stats.occupied - stats.current)
+     << std::endl;
+  os << "info string tt bounds upper " << stats.bounds[static_cast<std::size_t>(bound_type::upper)] << " lower "
+     << stats.bounds[static_cast<std::size_t>(bound_type::lower)] << " exact " << stats.bounds[static_cast<std::size_t>(bound_type::exact)]
+     << std::endl;
+
+  os << "info string tt depths";
+  for (std::size_t depth(0); depth < stats.depths.size(); ++depth) {
+    if (stats.depths[depth] != 0) { os << ' ' << depth << ':' << stats.depths[depth]; }
+  }
+
+  return os << std::endl;
+}
+
 }  // namespace search
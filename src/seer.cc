@@ -16,18 +16,26 @@
 */
 
 #include <engine/uci.h>
+#include <util/string.h>
 
 #include <iostream>
 #include <string>
 
+// fat builds compile the engine once per instruction set tier and rename
+// the entry point of each tier (see src/dispatch/seer_dispatch.cc)
+#if defined(SEER_ENTRY)
+extern "C" int SEER_ENTRY(const int argc, const char* argv[]) {
+#else
 int main(const int argc, const char* argv[]) {
+#endif
   engine::uci uci{};
 
-  const bool perform_bench = (argc == 2) && (std::string(argv[1]) == "bench");
+  const bool perform_bench = (argc >= 2) && (std::string(argv[1]) == "bench");
   if (perform_bench) {
-    uci.bench();
+    uci.bench(util::string::join(argv + 2, argv + argc, " "));
     return 0;
   }
 
   for (std::string line{}; !uci.should_quit() && std::getline(std::cin, line);) { uci.read(line); }
+  return 0;
 }